@@ -0,0 +1,565 @@
+#include "Delimiters.h"
+#include "Distributor.h"
+#include "FormDatabase.h"
+#include "Generator.h"
+#include "Map.h"
+#include "Parser.h"
+#include "RuleTable.h"
+#include "Settings.h"
+#include "Utility.h"
+
+// Microbenchmarks of the parser, rule table and distributor on the stand-in form database, and a scaling run over generated packs. Results are written to stdout as JSON.
+// A name given on the command line runs only the groups containing it, and name=value arguments override the GeneratorConfig fields and the number of scaling steps
+namespace
+{
+    struct Result
+    {
+        std::string name{};
+        u64         items{};
+        double      best_ns{};
+        double      median_ns{};
+    };
+
+    struct ScalingResult
+    {
+        u64    rules{};
+        u64    containers{};
+        double parse_ms{};
+        u64    table_bytes{};
+        u64    distr_map_bytes{}; // Freed once the table is frozen, unless INIs are watched
+        u64    editor_id_bytes{};
+        double distribute_ns{};
+    };
+
+    // One sample line per grammar and form of reference: FormID~plugin, editor ID with a location and chance, and a location keyword
+    struct Samples
+    {
+        std::array<std::string, 3> add{};
+        std::array<std::string, 3> remove{};
+        std::array<std::string, 3> remove_all{};
+
+        [[nodiscard]] const std::array<std::string, 3>& Get(const u64 r) const noexcept { return r % 3 == 0 ? add : r % 3 == 1 ? remove : remove_all; }
+    };
+
+    std::vector<Result> results{};
+
+    std::vector<ScalingResult> scaling_results{};
+
+    GeneratorConfig generator{};
+
+    u32 scaling_steps{ 4 };
+
+    u64 sink{};
+
+    std::string_view filter{};
+
+    [[nodiscard]] bool Selected(const std::string_view group) noexcept
+    {
+        return group.contains(filter);
+    }
+
+    // Times f(), which processes items items per call, over several repetitions and records the per-item cost
+    template <typename F>
+    void Measure(std::string name, const u64 items, F&& f, const std::size_t repetitions = 7) noexcept
+    {
+        using clock = std::chrono::steady_clock;
+
+        f(); // warm up caches and thread_local buffers
+
+        std::vector<double> samples(repetitions);
+        for (auto& sample : samples) {
+            const auto start{ clock::now() };
+            f();
+            sample = std::chrono::duration<double, std::nano>(clock::now() - start).count() / static_cast<double>(items);
+        }
+        std::ranges::sort(samples);
+
+        results.emplace_back(std::move(name), items, samples.front(), samples[repetitions / 2]);
+    }
+
+    [[nodiscard]] std::string GenerateINI(const Samples& samples, const std::vector<std::string>& containers, const std::size_t lines) noexcept
+    {
+        std::string text{ "[General]\n" };
+        text.reserve(lines * 48);
+
+        // Deterministic, so runs on different builds parse the same input
+        for (std::size_t i{}; i < lines; ++i) {
+            const auto r{ Utility::Mix(i) };
+            std::format_to(std::back_inserter(text), "{} = {}\n", containers[(r >> 8) % containers.size()], samples.Get(r)[(r >> 4) % 3]);
+        }
+
+        return text;
+    }
+
+    [[nodiscard]] bool SetOption(const std::string_view name, const std::string_view value) noexcept
+    {
+        const std::array<std::pair<std::string_view, u32*>, 11> options{ { { "files", &generator.files },
+                                                                           { "containers_per_file", &generator.containers_per_file },
+                                                                           { "rules_per_container", &generator.rules_per_container },
+                                                                           { "remove_percent", &generator.remove_percent },
+                                                                           { "remove_all_percent", &generator.remove_all_percent },
+                                                                           { "leveled_percent", &generator.leveled_percent },
+                                                                           { "chance_percent", &generator.chance_percent },
+                                                                           { "location_percent", &generator.location_percent },
+                                                                           { "keyword_percent", &generator.keyword_percent },
+                                                                           { "seed", &generator.seed },
+                                                                           { "steps", &scaling_steps } } };
+
+        const auto it{ std::ranges::find(options, name, &std::pair<std::string_view, u32*>::first) };
+        if (it == options.end()) {
+            return false;
+        }
+
+        const auto [ptr, ec]{ std::from_chars(value.data(), value.data() + value.size(), *it->second) };
+
+        return ec == std::errc{} && ptr == value.data() + value.size();
+    }
+
+    // Parses generated packs of containers_per_file containers per file, 10x more each step, and distributes to references placed in their containers and locations
+    void RunScaling(FormDatabase& db) noexcept
+    {
+        using clock = std::chrono::steady_clock;
+
+        constexpr std::size_t refs_per_pass{ 1'000 };
+        constexpr std::size_t passes{ 3 };
+
+        auto config{ generator };
+        for (u32 step{}; step < scaling_steps; ++step, config.containers_per_file *= 10) {
+            // Only the pack's forms and files, so every step starts from the same state
+            db.Clear();
+            Map::processed_containers.Clear();
+            Map::respawn_containers.Clear();
+            Map::added_objects.Clear();
+
+            std::error_code ec{};
+            std::filesystem::remove_all(db.data_directory, ec);
+
+            const auto pack{ Generator::Write(db, db.data_directory, config) };
+            if (pack.files.empty() || pack.containers.empty()) {
+                break;
+            }
+
+            auto parse_ms{ std::numeric_limits<double>::max() };
+            for (std::size_t i{}; i < passes; ++i) {
+                const auto start{ clock::now() };
+                Parser::ParseINIs();
+                parse_ms = std::min(parse_ms, std::chrono::duration<double, std::milli>(clock::now() - start).count());
+            }
+            const auto table_bytes{ RuleTable::MemoryUsage() };
+
+            // One more parse that keeps distr_map, the peak of parsing. Last, since the table it freezes keeps room for hot reload
+            const auto watch_inis{ Settings::watch_inis };
+            Settings::watch_inis = true;
+            Parser::ParseINIs();
+            const auto distr_map_bytes{ Map::DistrMapMemoryUsage() };
+            Map::distr_map       = {};
+            Settings::watch_inis = watch_inis;
+
+            std::vector<RE::TESObjectREFR*> refs;
+            refs.reserve(refs_per_pass * passes);
+            for (std::size_t i{}; i < refs_per_pass * passes; ++i) {
+                const auto r{ Utility::Mix(config.seed ^ i) };
+                const auto ref{ db.AddReference("", "", pack.containers[r % pack.containers.size()], pack.locations[(r >> 32) % pack.locations.size()]) };
+                for (const auto item : pack.stock) {
+                    ref->inventory[item] = 100;
+                }
+                refs.emplace_back(ref);
+            }
+
+            auto distribute_ns{ std::numeric_limits<double>::max() };
+            for (std::size_t pass{}; pass < passes; ++pass) {
+                const auto start{ clock::now() };
+                for (std::size_t i{}; i < refs_per_pass; ++i) {
+                    Distributor::Distribute(refs[pass * refs_per_pass + i]);
+                }
+                distribute_ns = std::min(distribute_ns, std::chrono::duration<double, std::nano>(clock::now() - start).count() / refs_per_pass);
+            }
+
+            scaling_results.emplace_back(pack.rules, pack.containers.size(), parse_ms, table_bytes, distr_map_bytes, EditorIDs::MemoryUsage(), distribute_ns);
+        }
+    }
+
+    // A one-line edit picked up by hot reload, and the Freeze it ends with, on generated packs of the same sizes as the scaling run
+    void RunReload(FormDatabase& db) noexcept
+    {
+        const auto watch_inis{ Settings::watch_inis };
+        Settings::watch_inis = true;
+
+        auto config{ generator };
+        for (u32 step{}; step < scaling_steps; ++step, config.containers_per_file *= 10) {
+            // Watching keeps distr_map alive, and ParseINIs adds to it
+            db.Clear();
+            Map::distr_map = {};
+
+            std::error_code ec{};
+            std::filesystem::remove_all(db.data_directory, ec);
+
+            const auto pack{ Generator::Write(db, db.data_directory, config) };
+            if (pack.files.empty() || pack.containers.empty()) {
+                break;
+            }
+
+            Parser::ParseINIs();
+
+            Measure(std::format("Freeze/{}", pack.rules), 1, [] { RuleTable::Freeze(); }, 3);
+
+            // Each call adds or takes back one rule at the end of the first file
+            const auto& path{ pack.files.front() };
+            std::string text{};
+            {
+                std::ifstream file{ path, std::ios::binary };
+                text.assign(std::istreambuf_iterator<char>{ file }, {});
+            }
+            const auto edited{ std::format("{}{} = GenItem0|1\n", text, db.GetIdentifier(pack.containers.front())) };
+
+            bool toggle{};
+            Measure(
+                std::format("ReloadINIs/{}", pack.rules), 1,
+                [&] {
+                    toggle = !toggle;
+                    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+                    file << (toggle ? edited : text);
+                    file.close();
+                    Parser::ReloadINIs({ path });
+                },
+                3);
+        }
+
+        Map::distr_map       = {};
+        Settings::watch_inis = watch_inis;
+    }
+
+    void WriteINI(const std::string_view text) noexcept
+    {
+        std::ofstream file{ FormDatabase::Get().data_directory / "Bench_CID.ini", std::ios::binary | std::ios::trunc };
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    void WriteResults() noexcept
+    {
+        std::string json{};
+        auto        out{ std::back_inserter(json) };
+
+        std::format_to(out, "{{\n  \"version\": \"{}\",\n  \"results\": [\n", Game::GetPluginVersion());
+        for (std::size_t i{}; i < results.size(); ++i) {
+            const auto& [name, items, best_ns, median_ns]{ results[i] };
+            std::format_to(out, "    {{ \"name\": \"{}\", \"items\": {}, \"best_ns_per_item\": {:.3f}, \"median_ns_per_item\": {:.3f} }}{}\n", name, items, best_ns, median_ns,
+                           i + 1 < results.size() ? "," : "");
+        }
+        std::format_to(out, "  ],\n  \"scaling\": [\n");
+        for (std::size_t i{}; i < scaling_results.size(); ++i) {
+            const auto& [rules, containers, parse_ms, table_bytes, distr_map_bytes, editor_id_bytes, distribute_ns]{ scaling_results[i] };
+            std::format_to(out,
+                           "    {{ \"rules\": {}, \"containers\": {}, \"parse_ms\": {:.3f}, \"table_bytes\": {}, \"distr_map_bytes\": {}, \"editor_id_bytes\": {}, \"bytes\": {}, "
+                           "\"distribute_ns_per_container\": {:.3f} }}{}\n",
+                           rules, containers, parse_ms, table_bytes, distr_map_bytes, editor_id_bytes, table_bytes + distr_map_bytes + editor_id_bytes, distribute_ns,
+                           i + 1 < scaling_results.size() ? "," : "");
+        }
+        std::format_to(out, "  ]\n}}\n");
+
+        std::fwrite(json.data(), 1, json.size(), stdout);
+    }
+} // namespace
+
+int main(const int argc, const char* argv[])
+{
+    // Distribution messages would only fill the log ring, which no thread drains here
+    spdlog::set_level(spdlog::level::warn);
+
+    Settings::use_cache = false;
+
+    for (const std::string_view arg : std::span{ argv + 1, argv + argc }) {
+        if (const auto pos{ arg.find('=') }; pos == std::string_view::npos) {
+            filter = arg;
+        }
+        else if (!SetOption(arg.substr(0, pos), arg.substr(pos + 1))) {
+            logger::error("ERROR: Invalid option {}", arg);
+            return 1;
+        }
+    }
+
+    auto& db{ FormDatabase::Get() };
+    db.Clear();
+    db.AddPlugin("Skyrim.esm");
+    db.AddPlugin("Bench.esp");
+    db.data_directory = std::filesystem::temp_directory_path() / "CIDBench";
+    db.log_directory  = db.data_directory;
+
+    std::filesystem::remove_all(db.data_directory);
+    std::filesystem::create_directories(db.data_directory);
+
+    const auto sword{ db.AddItem("Skyrim.esm", "IronSword") };
+    db.AddItem("Skyrim.esm", "Gold001");
+    const auto potion{ db.AddItem("Skyrim.esm", "RestoreHealth") };
+    db.AddLeveledList("Skyrim.esm", "LItemPotionRestoreHealth", { { .form = potion, .count = 1, .level = 1 } });
+    db.AddLocation("Skyrim.esm", "WhiterunLocation", { db.AddKeyword("Skyrim.esm", "LocTypeCity") });
+    db.AddKeyword("Skyrim.esm", "LocTypeDungeon");
+
+    std::vector<std::string> containers;
+    for (u32 i{}; i < 4096; ++i) {
+        containers.emplace_back(db.GetIdentifier(db.AddContainer("Bench.esp", std::format("BenchChest{}", i))));
+    }
+
+    const auto    sword_id{ db.GetIdentifier(sword) };
+    const Samples samples{ .add        = { std::format("{}|3", sword_id), "IronSword|1|WhiterunLocation?50", "LItemPotionRestoreHealth|2@LocTypeDungeon" },
+                           .remove     = { std::format("-{}|3", sword_id), "-IronSword|1|WhiterunLocation?50", "-Gold001|100@LocTypeCity?25" },
+                           .remove_all = { std::format("-{}", sword_id), "-IronSword?50", "-Gold001@LocTypeCity" } };
+
+    // Parser kernels
+    if (Selected("ClassifyString")) {
+        constexpr u64 iterations{ 1'000'000 };
+
+        Measure("ClassifyString", iterations, [&] {
+            for (u64 i{}; i < iterations; ++i) {
+                sink += std::to_underlying(Parser::ClassifyString(samples.Get(i)[i / 3 % 3]));
+            }
+        });
+    }
+
+    if (Selected("Tokenize")) {
+        constexpr u64 iterations{ 1'000'000 };
+
+        const auto tokenize{ [&](const std::string_view name, const auto& lines, const DistrType type) {
+            Measure(std::format("Tokenize/{}", name), iterations, [&] {
+                for (u64 i{}; i < iterations; ++i) {
+                    sink += Parser::Tokenize(lines[i % lines.size()], containers.front(), type).count;
+                }
+            });
+        } };
+        tokenize("Add", samples.add, DistrType::Add);
+        tokenize("Remove", samples.remove, DistrType::Remove);
+        tokenize("RemoveAll", samples.remove_all, DistrType::RemoveAll);
+    }
+
+    // Delimiter scanning on long values: the separate scalar walks the parser used to make against one mask pass, scalar and vectorized
+    for (const std::size_t length : { 64, 256, 1'024, 4'096 }) {
+        if (!Selected("Delimiters")) {
+            break;
+        }
+
+        std::string line{};
+        while (line.size() < length) {
+            line.append("0x12EB7~LongPluginName.esp|");
+        }
+        line.resize(length - 14);
+        line.append("@LocTypeCity?5");
+
+        const auto iterations{ 64'000'000 / length };
+        const auto queries{ [](const std::string_view s, const DelimiterMask& mask) {
+            u64 result{ mask.Count(Delimiter::Bar, 0, s.size()) + mask.RFind(Delimiter::Question, 0, s.size()) + mask.RFind(Delimiter::At, 0, s.size()) };
+            for (auto pos{ mask.Find(Delimiter::Bar, 0, s.size()) }; pos != std::string_view::npos; pos = mask.Find(Delimiter::Bar, pos + 1, s.size())) {
+                result += pos;
+            }
+            return result;
+        } };
+
+        Measure(std::format("Delimiters/MultiPass/{}", length), iterations * length, [&] {
+            for (u64 i{}; i < iterations; ++i) {
+                const std::string_view s{ line };
+                sink += static_cast<u64>(std::ranges::count(s, '|')) + s.rfind('?') + s.rfind('@');
+                for (auto pos{ s.find('|') }; pos != std::string_view::npos; pos = s.find('|', pos + 1)) {
+                    sink += pos;
+                }
+            }
+        });
+
+        Measure(std::format("Delimiters/ScanScalar/{}", length), iterations * length, [&] {
+            thread_local DelimiterMask mask;
+            for (u64 i{}; i < iterations; ++i) {
+                mask.ScanScalar(line);
+                sink += queries(line, mask);
+            }
+        });
+
+        Measure(std::format("Delimiters/Scan/{}", length), iterations * length, [&] {
+            thread_local DelimiterMask mask;
+            for (u64 i{}; i < iterations; ++i) {
+                mask.Scan(line);
+                sink += queries(line, mask);
+            }
+        });
+    }
+
+    // The whole of ParseINIs over one synthetic file: read, lex, tokenize, resolve against the database and freeze
+    for (const std::size_t lines : { 1'000, 10'000, 100'000, 1'000'000 }) {
+        if (!Selected("ParseINIs")) {
+            break;
+        }
+
+        WriteINI(GenerateINI(samples, containers, lines));
+
+        Measure(std::format("ParseINIs/{}", lines), lines, [] { Parser::ParseINIs(); }, lines < 100'000 ? 7 : 3);
+    }
+
+    // Rule table lookups for every container with rules, and for references without any
+    if (Selected("RuleTable")) {
+        WriteINI(GenerateINI(samples, containers, containers.size() * 4));
+        Parser::ParseINIs();
+
+        const auto    form_ids{ RuleTable::FormIDs() };
+        constexpr u64 iterations{ 1'000'000 };
+
+        Measure("RuleTable/Find", iterations, [&] {
+            for (u64 i{}; i < iterations; ++i) {
+                sink += RuleTable::Find(form_ids[i % form_ids.size()]).has_value();
+            }
+        });
+
+        Measure("RuleTable/MayContainMiss", iterations, [&] {
+            for (u64 i{}; i < iterations; ++i) {
+                sink += RuleTable::MayContain(static_cast<RE::FormID>(Utility::Mix(i)) | 0xFF000000);
+            }
+        });
+    }
+
+    // Distribute on references of one container with 0 to 500 rules: adds and leveled adds over a pool of items, some behind a chance roll, and removes and remove-alls
+    // of the items every reference starts with
+    if (Selected("Distribute")) {
+        std::vector<RE::TESBoundObject*> items;
+        std::vector<RE::TESLevItem*>     leveled_lists;
+        for (u32 i{}; i < 64; ++i) {
+            items.emplace_back(db.AddItem("Bench.esp", std::format("BenchItem{}", i)));
+        }
+        for (u32 i{}; i < 8; ++i) {
+            leveled_lists.emplace_back(db.AddLeveledList("Bench.esp", std::format("BenchLeveled{}", i),
+                                                         { { .form = items[i], .count = 1, .level = 1 }, { .form = items[i + 8], .count = 2, .level = 1 } }));
+        }
+
+        constexpr std::size_t refs_per_call{ 1'000 };
+        constexpr std::size_t repetitions{ 7 };
+        constexpr std::size_t held_items{ 16 };
+
+        for (const u32 rule_count : { 0, 1, 10, 100, 500 }) {
+            const auto chest{ db.AddContainer("Bench.esp", std::format("BenchDistributeChest{}", rule_count)) };
+
+            const auto& container{ chest->editorID };
+
+            std::string text{ "[General]\n" };
+            for (u32 j{}; j < rule_count; ++j) {
+                switch (j % 10) {
+                case 6:
+                    std::format_to(std::back_inserter(text), "{} = BenchLeveled{}|1\n", container, j % leveled_lists.size());
+                    break;
+                case 9:
+                    // A second remove-all of the same item finds nothing left to remove
+                    if (j / 10 < held_items) {
+                        std::format_to(std::back_inserter(text), "{} = -BenchItem{}\n", container, j / 10);
+                        break;
+                    }
+                    [[fallthrough]];
+                case 7:
+                case 8:
+                    std::format_to(std::back_inserter(text), "{} = -BenchItem{}|1\n", container, j % held_items);
+                    break;
+                default:
+                    std::format_to(std::back_inserter(text), "{} = BenchItem{}|{}{}\n", container, j % items.size(), 1 + j % 3, j % 4 == 0 ? "?50" : "");
+                    break;
+                }
+            }
+            WriteINI(text);
+            Parser::ParseINIs();
+
+            // Each reference is distributed once, so every call gets fresh ones
+            std::vector<RE::TESObjectREFR*> refs;
+            refs.reserve(refs_per_call * (repetitions + 1));
+            for (std::size_t i{}; i < refs_per_call * (repetitions + 1); ++i) {
+                const auto ref{ db.AddReference("", "", chest) };
+                for (std::size_t k{}; k < held_items; ++k) {
+                    ref->inventory[items[k]] = 100;
+                }
+                refs.emplace_back(ref);
+            }
+
+            std::size_t next{};
+            Measure(
+                std::format("Distribute/{}", rule_count), refs_per_call,
+                [&] {
+                    for (std::size_t i{}; i < refs_per_call; ++i) {
+                        Distributor::Distribute(refs[next++]);
+                    }
+                },
+                repetitions);
+        }
+    }
+
+    // Nested leveled lists, where every level adds two lists of the next one and two items out of a small pool, so the same items come up many times per list
+    if (Selected("DistributeLeveled")) {
+        std::vector<RE::TESBoundObject*> items;
+        for (u32 i{}; i < 8; ++i) {
+            items.emplace_back(db.AddItem("Bench.esp", std::format("BenchNestedItem{}", i)));
+        }
+
+        constexpr std::size_t refs_per_call{ 1'000 };
+        constexpr std::size_t repetitions{ 7 };
+
+        for (const u32 depth : { 1, 2, 4, 6 }) {
+            std::vector<RE::TESLevItem*> level;
+            for (u32 d{ depth }; d > 0; --d) {
+                std::vector<RE::TESLevItem*> next;
+                for (u32 i{}; i < 1U << (d - 1); ++i) {
+                    std::vector<RE::TESLevItem::Entry> entries{ { .form = items[i % items.size()], .count = 1, .level = 1 }, { .form = items[(i + d) % items.size()], .count = 3, .level = 1 } };
+                    if (!level.empty()) {
+                        entries.push_back({ .form = level[i * 2], .count = 1, .level = 1 });
+                        entries.push_back({ .form = level[i * 2 + 1], .count = 2, .level = 1 });
+                    }
+                    next.emplace_back(db.AddLeveledList("Bench.esp", std::format("BenchNested{}_{}_{}", depth, d, i), entries));
+                }
+                level = std::move(next);
+            }
+
+            const auto chest{ db.AddContainer("Bench.esp", std::format("BenchNestedChest{}", depth)) };
+            WriteINI(std::format("[General]\n{} = {}|2\n", chest->editorID, level.front()->editorID));
+            Parser::ParseINIs();
+
+            std::vector<RE::TESObjectREFR*> refs;
+            refs.reserve(refs_per_call * (repetitions + 1));
+            for (std::size_t i{}; i < refs_per_call * (repetitions + 1); ++i) {
+                refs.emplace_back(db.AddReference("", "", chest));
+            }
+
+            std::size_t next{};
+            Measure(
+                std::format("DistributeLeveled/{}", depth), refs_per_call,
+                [&] {
+                    for (std::size_t i{}; i < refs_per_call; ++i) {
+                        Distributor::Distribute(refs[next++]);
+                    }
+                },
+                repetitions);
+        }
+    }
+
+    if (Selected("RollChance")) {
+        constexpr u64 iterations{ 1'000'000 };
+
+        Measure("RollChance", iterations, [] {
+            for (u64 i{}; i < iterations; ++i) {
+                sink += Utility::RollChance(50, static_cast<RE::FormID>(i), DistrType::Add, i);
+            }
+        });
+
+        // The roll it replaced, one shared engine and distribution drawing 1-100
+        Measure("RollChance/mt19937", iterations, [] {
+            static std::mt19937                       rng{ std::random_device{}() };
+            static std::uniform_int_distribution<u16> distr{ 1, 100 };
+            for (u64 i{}; i < iterations; ++i) {
+                sink += distr(rng) <= 50;
+            }
+        });
+    }
+
+    if (Selected("Reload")) {
+        RunReload(db);
+    }
+
+    if (Selected("Scaling")) {
+        RunScaling(db);
+    }
+
+    std::error_code ec{};
+    std::filesystem::remove_all(db.data_directory, ec);
+
+    WriteResults();
+
+    return results.empty() && scaling_results.empty() ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+#include "Generator.h"
+
+#include "Utility.h"
+
+Generator::FormPool Generator::AddForms(FormDatabase& db, const GeneratorConfig& config, GeneratedPack& pack) noexcept
+{
+    constexpr u32 items{ 1'024 };
+    constexpr u32 stock{ 32 };
+    constexpr u32 leveled_items{ 128 };
+    constexpr u32 locations{ 64 };
+    constexpr u32 location_keywords{ 16 };
+
+    FormPool pool{};
+
+    db.AddPlugin(std::string{ plugin });
+
+    std::vector<RE::TESBoundObject*> item_forms;
+    for (u32 i{}; i < items; ++i) {
+        const auto item{ item_forms.emplace_back(db.AddItem(plugin, std::format("GenItem{}", i))) };
+        if (i < stock) {
+            pack.stock.emplace_back(item);
+            pool.stock.emplace_back(item->editorID);
+        }
+        else {
+            pool.items.emplace_back(item->editorID);
+        }
+    }
+
+    for (u32 i{}; i < leveled_items; ++i) {
+        const auto leveled_list{ db.AddLeveledList(plugin, std::format("GenLeveled{}", i),
+                                                   { { .form = item_forms[i * 7 % items], .count = 1, .level = 1 }, { .form = item_forms[i * 13 % items], .count = 2, .level = 1 } }) };
+        pool.leveled_items.emplace_back(leveled_list->editorID);
+    }
+
+    std::vector<RE::BGSKeyword*> keywords;
+    for (u32 i{}; i < location_keywords; ++i) {
+        pool.location_keywords.emplace_back(keywords.emplace_back(db.AddKeyword(plugin, std::format("LocTypeGen{}", i)))->editorID);
+    }
+
+    for (u32 i{}; i < locations; ++i) {
+        const auto location{ pack.locations.emplace_back(db.AddLocation(plugin, std::format("GenLocation{}", i), { keywords[i % location_keywords] })) };
+        pool.locations.emplace_back(location->editorID);
+    }
+
+    // Containers are named by FormID, the way most packs refer to vanilla ones
+    const auto containers{ static_cast<u64>(config.files) * config.containers_per_file };
+    for (u64 i{}; i < containers; ++i) {
+        const auto container{ pack.containers.emplace_back(db.AddContainer(plugin, std::format("GenChest{}", i))) };
+        pool.containers.emplace_back(db.GetIdentifier(container));
+    }
+
+    return pool;
+}
+
+GeneratedPack Generator::Write(FormDatabase& db, const std::filesystem::path& dir, const GeneratorConfig& config) noexcept
+{
+    GeneratedPack pack{};
+
+    const auto pool{ AddForms(db, config, pack) };
+
+    std::error_code ec{};
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        logger::error("ERROR: Failed to create {} ({})", dir.string(), ec.message());
+        return pack;
+    }
+
+    // Counter-based, so a given config and seed always produce the same pack
+    u64        counter{};
+    const auto next{ [&] { return Utility::Mix(config.seed ^ Utility::Mix(++counter)); } };
+    const auto pick{ [&](const std::vector<std::string>& strings) -> const std::string& { return strings[next() % strings.size()]; } };
+    const auto roll{ [&](const u32 percent) { return next() % 100 < percent; } };
+
+    pack.files.reserve(config.files);
+
+    std::string                     text{};
+    std::vector<const std::string*> removed_all;
+    for (u32 f{}; f < config.files; ++f) {
+        text.assign("[General]\n");
+        auto out{ std::back_inserter(text) };
+
+        for (u32 c{}; c < config.containers_per_file; ++c) {
+            const auto& container{ pool.containers[static_cast<u64>(f) * config.containers_per_file + c] };
+
+            removed_all.clear();
+            for (u32 r{}; r < config.rules_per_container; ++r) {
+                const auto type_roll{ next() % 100 };
+                auto       type{ type_roll < config.remove_all_percent                         ? DistrType::RemoveAll :
+                                 type_roll < config.remove_all_percent + config.remove_percent ? DistrType::Remove :
+                                                                                                 DistrType::Add };
+
+                // Removals only name items containers are stocked with, and leveled lists are only distributed by add rules
+                const auto& object{ type != DistrType::Add ? pick(pool.stock) : roll(config.leveled_percent) ? pick(pool.leveled_items) : pick(pool.items) };
+
+                // A second remove-all of the same object would find nothing left to remove
+                if (type == DistrType::RemoveAll) {
+                    if (std::ranges::contains(removed_all, &object)) {
+                        type = DistrType::Remove;
+                    }
+                    else {
+                        removed_all.emplace_back(&object);
+                    }
+                }
+
+                std::format_to(out, "{} = {}{}", container, type == DistrType::Add ? "" : "-", object);
+                if (type != DistrType::RemoveAll) {
+                    std::format_to(out, "|{}", 1 + next() % 5);
+                }
+                // Remove-all rules have no fields, so they can only be conditioned on a location keyword
+                if (type != DistrType::RemoveAll && roll(config.location_percent)) {
+                    std::format_to(out, "|{}", pick(pool.locations));
+                }
+                else if (roll(config.keyword_percent)) {
+                    std::format_to(out, "@{}", pick(pool.location_keywords));
+                }
+                if (roll(config.chance_percent)) {
+                    std::format_to(out, "?{}", 1 + next() % 99);
+                }
+                text.push_back('\n');
+            }
+        }
+
+        auto path{ dir / std::format("Generated{:04}_CID.ini", f) };
+
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!file) {
+            logger::error("ERROR: Failed to write {}", path.filename().string());
+            continue;
+        }
+
+        pack.files.emplace_back(std::move(path));
+        pack.rules += static_cast<u64>(config.containers_per_file) * config.rules_per_container;
+    }
+
+    return pack;
+}
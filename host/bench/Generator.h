@@ -0,0 +1,51 @@
+#pragma once
+
+#include "FormDatabase.h"
+
+struct GeneratorConfig
+{
+    u32 files{ 10 };
+    u32 containers_per_file{ 10 };
+    u32 rules_per_container{ 10 };
+    // Percentages of all rules
+    u32 remove_percent{ 20 };
+    u32 remove_all_percent{ 10 };
+    u32 leveled_percent{ 15 };
+    u32 chance_percent{ 30 };
+    u32 location_percent{ 10 };
+    u32 keyword_percent{ 10 };
+    u32 seed{};
+};
+
+// What a pack references, so references can be placed in its containers and locations and stocked with the items it removes
+struct GeneratedPack
+{
+    std::vector<std::filesystem::path> files{};
+    std::vector<RE::TESObjectCONT*>    containers{};
+    std::vector<RE::BGSLocation*>      locations{};
+    std::vector<RE::TESBoundObject*>   stock{};
+    u64                                rules{};
+};
+
+// Fills the stand-in form database with synthetic forms and writes packs of _CID.ini files that reference them, for load and scaling tests without a real modlist
+class Generator
+{
+    struct FormPool
+    {
+        std::vector<std::string> containers{};
+        std::vector<std::string> items{};
+        std::vector<std::string> stock{};
+        std::vector<std::string> leveled_items{};
+        std::vector<std::string> locations{};
+        std::vector<std::string> location_keywords{};
+    };
+
+    [[nodiscard]] static FormPool AddForms(FormDatabase& db, const GeneratorConfig& config, GeneratedPack& pack) noexcept;
+
+public:
+    inline static constexpr auto plugin{ "Generated.esp"sv };
+
+    // Adds the forms under plugin, which must not be loaded yet, and writes the files to dir, sorted like Parser::FindINIs. A given config and seed always produce the same
+    // pack
+    [[nodiscard]] static GeneratedPack Write(FormDatabase& db, const std::filesystem::path& dir, const GeneratorConfig& config) noexcept;
+};
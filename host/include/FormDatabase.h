@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Game.h"
+#include "ankerl/unordered_dense.h"
+
+// In-memory stand-in for the game's form database. Tests and benchmarks fill it with plugins, items, leveled lists, locations, keywords, containers and references, and
+// Game serves the rule engine's lookups from it. Forms are only added and never move, so lookups are safe from any thread once it is filled
+class FormDatabase
+{
+    struct Plugin
+    {
+        std::string name{};
+        bool        is_light{};
+        u32         next_local_id{ 0x800 };
+    };
+
+    std::vector<Plugin> plugins{};
+
+    std::deque<std::unique_ptr<RE::TESForm>> forms{};
+
+    ankerl::unordered_dense::map<RE::FormID, RE::TESForm*> by_form_id{};
+
+    ankerl::unordered_dense::map<std::string, RE::TESForm*> by_editor_id{};
+
+    u32 next_dynamic_id{ 0xFF000800 };
+
+    [[nodiscard]] RE::FormID NextFormID(std::string_view plugin) noexcept;
+
+    template <typename T>
+    [[nodiscard]] T* Create(std::string_view plugin, std::string editor_id) noexcept;
+
+public:
+    [[nodiscard]] static FormDatabase& Get() noexcept;
+
+    std::filesystem::path data_directory{};
+
+    std::optional<std::filesystem::path> log_directory{};
+
+    u16 player_level{ 1 };
+
+    void Clear() noexcept;
+
+    // Full plugins take the next compile index, light plugins the next small file compile index under 0xFE
+    void AddPlugin(std::string name, bool is_light = false) noexcept;
+
+    RE::TESBoundObject* AddItem(std::string_view plugin, std::string editor_id) noexcept;
+
+    RE::TESLevItem* AddLeveledList(std::string_view plugin, std::string editor_id, std::vector<RE::TESLevItem::Entry> entries) noexcept;
+
+    RE::BGSKeyword* AddKeyword(std::string_view plugin, std::string editor_id) noexcept;
+
+    RE::BGSLocation* AddLocation(std::string_view plugin, std::string editor_id, std::vector<RE::BGSKeyword*> keywords) noexcept;
+
+    RE::TESObjectCONT* AddContainer(std::string_view plugin, std::string editor_id) noexcept;
+
+    RE::TESNPC* AddNPC(std::string_view plugin, std::string editor_id) noexcept;
+
+    // An empty plugin gives a reference created at runtime, with an 0xFF FormID
+    RE::TESObjectREFR* AddReference(std::string_view plugin, std::string editor_id, RE::TESBoundObject* base, RE::BGSLocation* location = nullptr) noexcept;
+
+    [[nodiscard]] RE::TESForm* LookupByID(RE::FormID form_id) const noexcept;
+
+    [[nodiscard]] RE::TESForm* LookupByEditorID(std::string_view editor_id) const noexcept;
+
+    // "0x<local FormID>~<plugin>", the way _CID.ini files name a form
+    [[nodiscard]] std::string GetIdentifier(const RE::TESForm* form) const noexcept;
+
+    [[nodiscard]] std::vector<PluginInfo> GetPlugins() const noexcept;
+
+    [[nodiscard]] std::size_t Size() const noexcept { return forms.size(); }
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+/* +++++++++++++++++++++++++ C++23 Standard Library +++++++++++++++++++++++++ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <execution>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <latch>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <shared_mutex>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+#include <spdlog/spdlog.h>
+
+using namespace std::literals;
+
+using u8  = std::uint8_t;
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using i8  = std::int8_t;
+using i16 = std::int16_t;
+using i32 = std::int32_t;
+using i64 = std::int64_t;
+
+#include "StandIn.h"
+
+// Same calls as SKSE::log, formatted with std::format and written to spdlog's default logger
+namespace logger
+{
+    template <typename... Args>
+    void Log(const spdlog::level::level_enum level, const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        if (const auto log{ spdlog::default_logger_raw() }; log->should_log(level)) {
+            log->log(level, std::format(fmt, std::forward<Args>(args)...));
+        }
+    }
+
+    template <typename... Args>
+    void debug(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::debug, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void info(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::info, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void warn(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::warn, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void error(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::err, fmt, std::forward<Args>(args)...);
+    }
+} // namespace logger
@@ -0,0 +1,82 @@
+#pragma once
+
+// Stand-ins for the CommonLibSSE types the rule engine uses. They only carry data: forms are owned by FormDatabase, and everything the engine asks of the game goes
+// through Game, which host/src/Game.cpp implements on the database
+namespace RE
+{
+    using FormID = u32;
+
+    class TESForm
+    {
+    public:
+        virtual ~TESForm() = default;
+
+        [[nodiscard]] FormID GetFormID() const noexcept { return formID; }
+
+        [[nodiscard]] const char* GetName() const noexcept { return name.c_str(); }
+
+        template <typename T>
+        [[nodiscard]] T* As() noexcept
+        {
+            return dynamic_cast<T*>(this);
+        }
+
+        template <typename T>
+        [[nodiscard]] const T* As() const noexcept
+        {
+            return dynamic_cast<const T*>(this);
+        }
+
+        FormID      formID{};
+        std::string editorID{};
+        std::string name{};
+    };
+
+    class TESBoundObject : public TESForm
+    {};
+
+    class TESObjectCONT : public TESBoundObject
+    {};
+
+    class TESNPC : public TESBoundObject
+    {};
+
+    class TESLevItem : public TESBoundObject
+    {
+    public:
+        struct Entry
+        {
+            TESBoundObject* form{};
+            u16             count{};
+            u16             level{};
+        };
+
+        std::vector<Entry> entries{};
+    };
+
+    class BGSKeyword : public TESForm
+    {};
+
+    class BGSLocation : public TESForm
+    {
+    public:
+        BGSKeyword** keywords{};
+        u32          numKeywords{};
+
+        std::vector<BGSKeyword*> keywordStorage{};
+    };
+
+    class TESObjectREFR : public TESForm
+    {
+    public:
+        using InventoryCountMap = std::map<TESBoundObject*, i32>;
+
+        [[nodiscard]] TESBoundObject* GetBaseObject() const noexcept { return baseObject; }
+
+        TESBoundObject*   baseObject{};
+        BGSLocation*      currentLocation{};
+        InventoryCountMap inventory{};
+        bool              loaded3D{ true };
+        bool              detached{};
+    };
+} // namespace RE
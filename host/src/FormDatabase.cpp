@@ -0,0 +1,177 @@
+#include "FormDatabase.h"
+
+namespace
+{
+    // Editor IDs are case-insensitive in the game
+    [[nodiscard]] std::string ToLower(const std::string_view s) noexcept
+    {
+        std::string result{ s };
+        std::ranges::transform(result, result.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+        return result;
+    }
+} // namespace
+
+FormDatabase& FormDatabase::Get() noexcept
+{
+    static FormDatabase database;
+
+    return database;
+}
+
+RE::FormID FormDatabase::NextFormID(const std::string_view plugin) noexcept
+{
+    if (plugin.empty()) {
+        return next_dynamic_id++;
+    }
+
+    u32 compile_index{};
+    u32 small_file_compile_index{};
+    for (auto& [name, is_light, next_local_id] : plugins) {
+        if (name != plugin) {
+            ++(is_light ? small_file_compile_index : compile_index);
+            continue;
+        }
+
+        const auto local_id{ next_local_id++ };
+        if (is_light) {
+            return 0xFE000000U | small_file_compile_index << 12 | (local_id & 0xFFFU);
+        }
+        return compile_index << 24 | (local_id & 0xFFFFFFU);
+    }
+
+    logger::error("ERROR: Stand-in plugin {} was never added", plugin);
+
+    return 0x0U;
+}
+
+template <typename T>
+T* FormDatabase::Create(const std::string_view plugin, std::string editor_id) noexcept
+{
+    auto form{ std::make_unique<T>() };
+    form->formID   = NextFormID(plugin);
+    form->name     = editor_id;
+    form->editorID = std::move(editor_id);
+
+    const auto ptr{ form.get() };
+    by_form_id.emplace(ptr->formID, ptr);
+    if (!ptr->editorID.empty()) {
+        by_editor_id.emplace(ToLower(ptr->editorID), ptr);
+    }
+    forms.emplace_back(std::move(form));
+
+    return ptr;
+}
+
+void FormDatabase::Clear() noexcept
+{
+    plugins.clear();
+    forms.clear();
+    by_form_id.clear();
+    by_editor_id.clear();
+    next_dynamic_id = 0xFF000800;
+    player_level    = 1;
+}
+
+void FormDatabase::AddPlugin(std::string name, const bool is_light) noexcept
+{
+    plugins.emplace_back(std::move(name), is_light);
+}
+
+RE::TESBoundObject* FormDatabase::AddItem(const std::string_view plugin, std::string editor_id) noexcept
+{
+    return Create<RE::TESBoundObject>(plugin, std::move(editor_id));
+}
+
+RE::TESLevItem* FormDatabase::AddLeveledList(const std::string_view plugin, std::string editor_id, std::vector<RE::TESLevItem::Entry> entries) noexcept
+{
+    const auto leveled_list{ Create<RE::TESLevItem>(plugin, std::move(editor_id)) };
+    leveled_list->entries = std::move(entries);
+
+    return leveled_list;
+}
+
+RE::BGSKeyword* FormDatabase::AddKeyword(const std::string_view plugin, std::string editor_id) noexcept
+{
+    return Create<RE::BGSKeyword>(plugin, std::move(editor_id));
+}
+
+RE::BGSLocation* FormDatabase::AddLocation(const std::string_view plugin, std::string editor_id, std::vector<RE::BGSKeyword*> keywords) noexcept
+{
+    const auto location{ Create<RE::BGSLocation>(plugin, std::move(editor_id)) };
+    location->keywordStorage = std::move(keywords);
+    location->keywords       = location->keywordStorage.data();
+    location->numKeywords    = static_cast<u32>(location->keywordStorage.size());
+
+    return location;
+}
+
+RE::TESObjectCONT* FormDatabase::AddContainer(const std::string_view plugin, std::string editor_id) noexcept
+{
+    return Create<RE::TESObjectCONT>(plugin, std::move(editor_id));
+}
+
+RE::TESNPC* FormDatabase::AddNPC(const std::string_view plugin, std::string editor_id) noexcept
+{
+    return Create<RE::TESNPC>(plugin, std::move(editor_id));
+}
+
+RE::TESObjectREFR* FormDatabase::AddReference(const std::string_view plugin, std::string editor_id, RE::TESBoundObject* base, RE::BGSLocation* location) noexcept
+{
+    const auto ref{ Create<RE::TESObjectREFR>(plugin, std::move(editor_id)) };
+    ref->baseObject      = base;
+    ref->currentLocation = location;
+
+    return ref;
+}
+
+RE::TESForm* FormDatabase::LookupByID(const RE::FormID form_id) const noexcept
+{
+    const auto it{ by_form_id.find(form_id) };
+
+    return it != by_form_id.end() ? it->second : nullptr;
+}
+
+RE::TESForm* FormDatabase::LookupByEditorID(const std::string_view editor_id) const noexcept
+{
+    const auto it{ by_editor_id.find(ToLower(editor_id)) };
+
+    return it != by_editor_id.end() ? it->second : nullptr;
+}
+
+std::string FormDatabase::GetIdentifier(const RE::TESForm* form) const noexcept
+{
+    const auto form_id{ form->GetFormID() };
+    const auto is_light{ form_id >> 24 == 0xFE };
+    const auto index{ is_light ? form_id >> 12 & 0xFFFU : form_id >> 24 };
+
+    u32 compile_index{};
+    u32 small_file_compile_index{};
+    for (const auto& [name, plugin_is_light, next_local_id] : plugins) {
+        if (plugin_is_light == is_light && (is_light ? small_file_compile_index : compile_index) == index) {
+            return std::format("{:#x}~{}", form_id & (is_light ? 0xFFFU : 0xFFFFFFU), name);
+        }
+        ++(plugin_is_light ? small_file_compile_index : compile_index);
+    }
+
+    return {};
+}
+
+std::vector<PluginInfo> FormDatabase::GetPlugins() const noexcept
+{
+    std::vector<PluginInfo> result;
+    result.reserve(plugins.size());
+
+    u8  compile_index{};
+    u16 small_file_compile_index{};
+    for (const auto& [name, is_light, next_local_id] : plugins) {
+        if (is_light) {
+            result.emplace_back(name, u8{ 0xFE }, small_file_compile_index++, true);
+        }
+        else {
+            result.emplace_back(name, compile_index++, u16{}, false);
+        }
+    }
+
+    return result;
+}
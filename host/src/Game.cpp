@@ -0,0 +1,100 @@
+#include "Game.h"
+
+#include "FormDatabase.h"
+#include "Map.h"
+
+RE::TESForm* Game::LookupByID(const RE::FormID form_id) noexcept
+{
+    return FormDatabase::Get().LookupByID(form_id);
+}
+
+RE::TESForm* Game::LookupByEditorID(const std::string_view editor_id) noexcept
+{
+    return FormDatabase::Get().LookupByEditorID(editor_id);
+}
+
+const char* Game::GetEditorID(const RE::TESForm* form) noexcept
+{
+    return form->editorID.c_str();
+}
+
+std::vector<PluginInfo> Game::GetPlugins() noexcept
+{
+    return FormDatabase::Get().GetPlugins();
+}
+
+void Game::CalculateLeveledList(RE::TESLevItem* leveled_list, const u32 count, std::vector<ObjectAndCount>& out) noexcept
+{
+    // Every entry at or below the player's level, for each of count rolls, like a list with "calculate for each item" set
+    for (u32 i{}; i < count; ++i) {
+        for (const auto& [form, entry_count, level] : leveled_list->entries) {
+            if (level > FormDatabase::Get().player_level) {
+                continue;
+            }
+            if (const auto nested{ form->As<RE::TESLevItem>() }) {
+                CalculateLeveledList(nested, entry_count, out);
+            }
+            else {
+                out.emplace_back(form, entry_count);
+            }
+        }
+    }
+}
+
+RE::BGSLocation* Game::GetCurrentLocation(RE::TESObjectREFR* ref) noexcept
+{
+    return ref->currentLocation;
+}
+
+RE::TESObjectREFR::InventoryCountMap Game::GetInventoryCounts(RE::TESObjectREFR* ref) noexcept
+{
+    return ref->inventory;
+}
+
+void Game::AddObject(RE::TESObjectREFR* ref, RE::TESBoundObject* obj, const i32 count) noexcept
+{
+    ref->inventory[obj] += count;
+}
+
+void Game::RemoveObject(RE::TESObjectREFR* ref, RE::TESBoundObject* obj, const i32 count) noexcept
+{
+    if (const auto it{ ref->inventory.find(obj) }; it != ref->inventory.end() && (it->second -= count) <= 0) {
+        ref->inventory.erase(it);
+    }
+}
+
+bool Game::Is3DLoaded(const RE::TESObjectREFR* ref) noexcept
+{
+    return ref->loaded3D;
+}
+
+bool Game::IsDetached(const RE::TESObjectREFR* ref) noexcept
+{
+    return ref->detached;
+}
+
+std::filesystem::path Game::GetDataDirectory() noexcept
+{
+    return FormDatabase::Get().data_directory;
+}
+
+std::optional<std::filesystem::path> Game::GetLogDirectory() noexcept
+{
+    return FormDatabase::Get().log_directory;
+}
+
+std::string_view Game::GetPluginName() noexcept
+{
+    return "ContainerItemDistributor";
+}
+
+std::string Game::GetPluginVersion() noexcept
+{
+    return CID_VERSION;
+}
+
+void Game::Fail(const std::string_view message) noexcept
+{
+    logger::error("{}: {}", GetPluginName(), message);
+    std::abort();
+}
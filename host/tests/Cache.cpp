@@ -0,0 +1,34 @@
+#include "Test.h"
+
+#include "Cache.h"
+#include "Game.h"
+
+TEST(FingerprintTracksPluginFiles)
+{
+    Test::Fixture fixture{ "FingerprintTracksPluginFiles" };
+    fixture.WriteFile("Test.esp", "TES4");
+    fixture.WriteFile("Test_CID.ini", "[General]\nChest = IronSword|1\n");
+
+    const std::vector cid_inis{ fixture.dir / "Test_CID.ini" };
+    const auto        before{ Cache::Fingerprint(cid_inis) };
+
+    CHECK(Cache::Fingerprint(cid_inis) == before);
+
+    // Same name and load order slot, different file
+    fixture.WriteFile("Test.esp", "TES4 updated");
+    CHECK(Cache::Fingerprint(cid_inis) != before);
+}
+
+TEST(CacheRejectsOversizedRuleCount)
+{
+    Test::Fixture fixture{ "CacheRejectsOversizedRuleCount" };
+
+    // A header that passes every other check, claiming far more rules than the file holds
+    constexpr u64      fingerprint{ 0x1234 };
+    std::array<u32, 6> header{ 0x43444943, 2 };
+    std::memcpy(&header[2], &fingerprint, sizeof(u64));
+    header[5] = 0x1000'0000;
+    fixture.WriteFile(std::format("{}.cache", Game::GetPluginName()), { reinterpret_cast<const char*>(header.data()), sizeof(header) });
+
+    CHECK(!Cache::Load(fingerprint).has_value());
+}
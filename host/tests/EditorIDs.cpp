@@ -0,0 +1,41 @@
+#include "Test.h"
+
+#include "EditorIDs.h"
+#include "Parser.h"
+
+TEST(EditorIDsInternRuleFormsOnly)
+{
+    Test::Fixture fixture{ "EditorIDsInternRuleFormsOnly" };
+    auto&         db{ fixture.db };
+
+    const auto sword{ db.AddItem("Test.esp", "IronSword") };
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+    const auto ref{ db.AddReference("", "ChestRef", chest) };
+
+    fixture.WriteFile("Test_CID.ini", "[General]\n"
+                                      "Chest = IronSword|1\n");
+    Parser::ParseINIs();
+
+    // Nothing is looked up until a message needs it
+    CHECK(EditorIDs::Size() == 0);
+    CHECK(!EditorIDs::Find(sword->GetFormID()).has_value());
+
+    EditorIDs::Intern(sword);
+    CHECK(EditorIDs::Find(sword->GetFormID()) == "IronSword");
+    CHECK(EditorIDs::Get(chest) == "Chest");
+    CHECK(EditorIDs::Size() == 2);
+
+    // The log thread only ever sees what was interned
+    EditorIDs::Intern(ref);
+    CHECK(!EditorIDs::Find(ref->GetFormID()).has_value());
+
+    // References are looked up each time, since their dynamic FormIDs get reused
+    CHECK(EditorIDs::Get(ref) == "ChestRef");
+    CHECK(EditorIDs::Size() == 2);
+    ref->editorID = "OtherRef";
+    CHECK(EditorIDs::Get(ref) == "OtherRef");
+
+    // Freezing again starts over with the new rules
+    Parser::ParseINIs();
+    CHECK(EditorIDs::Size() == 0);
+}
@@ -0,0 +1,60 @@
+#include "Test.h"
+
+#include "Map.h"
+#include "Scheduler.h"
+#include "Settings.h"
+
+Test::Fixture::Fixture(const std::string_view name) noexcept : dir(std::filesystem::temp_directory_path() / std::format("CIDTest-{}", name))
+{
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    db.Clear();
+    db.AddPlugin("Test.esp");
+    db.data_directory = dir;
+    db.log_directory  = dir;
+
+    Map::processed_containers.Clear();
+    Map::respawn_containers.Clear();
+    Map::added_objects.Clear();
+    Scheduler::Clear();
+}
+
+Test::Fixture::~Fixture() noexcept
+{
+    std::error_code ec{};
+    std::filesystem::remove_all(dir, ec);
+}
+
+void Test::Fixture::WriteFile(const std::string_view filename, const std::string_view text) const noexcept
+{
+    std::ofstream file{ dir / filename, std::ios::binary | std::ios::trunc };
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+int main(const int argc, const char* argv[])
+{
+    // Distribution messages would only fill the log ring, which no thread drains here
+    spdlog::set_level(spdlog::level::warn);
+
+    Settings::use_cache = false;
+
+    const std::string_view filter{ argc > 1 ? argv[1] : "" };
+
+    u32 ran{};
+    for (const auto& [name, func] : Test::Cases()) {
+        if (!name.contains(filter)) {
+            continue;
+        }
+
+        const auto failures{ Test::failures };
+        func();
+        ++ran;
+
+        spdlog::warn("{} {}", Test::failures == failures ? "PASS" : "FAIL", name);
+    }
+
+    spdlog::warn("{} tests, {} failed checks", ran, Test::failures);
+
+    return Test::failures == 0 && ran > 0 ? 0 : 1;
+}
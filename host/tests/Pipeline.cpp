@@ -0,0 +1,159 @@
+#include "Test.h"
+
+#include "Distributor.h"
+#include "Map.h"
+#include "ParseLog.h"
+#include "Parser.h"
+#include "RuleTable.h"
+
+namespace
+{
+    [[nodiscard]] i32 CountOf(const RE::TESObjectREFR* ref, RE::TESBoundObject* obj) noexcept
+    {
+        const auto it{ ref->inventory.find(obj) };
+
+        return it != ref->inventory.end() ? it->second : 0;
+    }
+} // namespace
+
+TEST(ClassifyString)
+{
+    CHECK(Parser::ClassifyString("IronSword|1") == DistrType::Add);
+    CHECK(Parser::ClassifyString("-IronSword|1") == DistrType::Remove);
+    CHECK(Parser::ClassifyString("-IronSword") == DistrType::RemoveAll);
+    CHECK(Parser::ClassifyString("IronSword") == DistrType::Error);
+}
+
+TEST(Tokenize)
+{
+    const auto add{ Parser::Tokenize("0x12EB7~Skyrim.esm|3|WhiterunLocation?50", "Chest", DistrType::Add) };
+    CHECK(add.type == DistrType::Add);
+    CHECK(add.identifier == "0x12EB7~Skyrim.esm");
+    CHECK(add.count == 3);
+    CHECK(add.location == "WhiterunLocation");
+    CHECK(add.chance == 50);
+
+    const auto remove{ Parser::Tokenize("-Gold001|100@LocTypeCity", "Chest", DistrType::Remove) };
+    CHECK(remove.identifier == "Gold001");
+    CHECK(remove.count == 100);
+    CHECK(remove.location_keyword == "LocTypeCity");
+    CHECK(remove.chance == 100);
+
+    CHECK(Parser::Tokenize("-IronSword?0x10", "Chest", DistrType::RemoveAll).type == DistrType::Error);
+}
+
+TEST(ParseLogCapture)
+{
+    ParseLog::Messages messages;
+    {
+        const ParseLog::Capture capture{ messages };
+        static_cast<void>(Parser::Tokenize("-IronSword?0x10", "Chest", DistrType::RemoveAll));
+    }
+    static_cast<void>(Parser::Tokenize("-IronSword?0x10", "Chest", DistrType::RemoveAll));
+
+    CHECK(messages.size() == 1);
+    CHECK(messages.front().level == spdlog::level::err);
+    CHECK(messages.front().text == "ERROR: IronSword?0x10 has an invalid chance");
+}
+
+TEST(ParseAndDistribute)
+{
+    Test::Fixture fixture{ "ParseAndDistribute" };
+    auto&         db{ fixture.db };
+
+    const auto sword{ db.AddItem("Test.esp", "IronSword") };
+    const auto gold{ db.AddItem("Test.esp", "Gold001") };
+    const auto potion{ db.AddItem("Test.esp", "RestoreHealth") };
+    const auto leveled_list{ db.AddLeveledList("Test.esp", "LItemPotions", { { .form = potion, .count = 2, .level = 1 } }) };
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+    const auto chest_ref{ db.AddReference("Test.esp", "ChestRef", chest) };
+    const auto other_ref{ db.AddReference("", "", chest) };
+    const auto unrelated_ref{ db.AddReference("", "", db.AddContainer("Test.esp", "Barrel")) };
+
+    chest_ref->inventory[gold] = 10;
+
+    fixture.WriteFile("Test_CID.ini", std::format("[General]\n"
+                                                 "Chest = IronSword|2\n"
+                                                 "chest = {}|1\n"
+                                                 "ChestRef = -Gold001|4\n"
+                                                 "ChestRef = LItemPotions|1\n"
+                                                 "Chest = -RestoreHealth\n"
+                                                 "Chest = Missing|1\n",
+                                                 db.GetIdentifier(sword)));
+
+    Parser::ParseINIs();
+
+    CHECK(RuleTable::Size() == 2);
+    CHECK(RuleTable::Find(chest->GetFormID()).has_value());
+    CHECK(!RuleTable::Find(unrelated_ref->GetFormID()).has_value());
+
+    // Rules on the reference replace the ones on its base object
+    Distributor::Distribute(chest_ref);
+    CHECK(CountOf(chest_ref, sword) == 0);
+    CHECK(CountOf(chest_ref, gold) == 6);
+    CHECK(CountOf(chest_ref, potion) == 2);
+
+    // Every rule is planned first as one net delta per object: its adds, then its removes clamped at zero, then a remove-all of whatever is left. Only then does the
+    // inventory change. This ref holds no RestoreHealth and no rule adds any, so the remove-all finds nothing to take
+    Distributor::Distribute(other_ref);
+    CHECK(CountOf(other_ref, sword) == 3);
+    CHECK(CountOf(other_ref, potion) == 0);
+
+    Distributor::Distribute(unrelated_ref);
+    CHECK(unrelated_ref->inventory.empty());
+
+    // Each container is distributed once
+    Distributor::Distribute(other_ref);
+    CHECK(CountOf(other_ref, sword) == 3);
+}
+
+TEST(LocationConditions)
+{
+    Test::Fixture fixture{ "LocationConditions" };
+    auto&         db{ fixture.db };
+
+    const auto sword{ db.AddItem("Test.esp", "IronSword") };
+    const auto gold{ db.AddItem("Test.esp", "Gold001") };
+    const auto city{ db.AddKeyword("Test.esp", "LocTypeCity") };
+    const auto whiterun{ db.AddLocation("Test.esp", "WhiterunLocation", { city }) };
+    const auto riverwood{ db.AddLocation("Test.esp", "RiverwoodLocation", {}) };
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+    const auto in_whiterun{ db.AddReference("", "", chest, whiterun) };
+    const auto in_riverwood{ db.AddReference("", "", chest, riverwood) };
+    const auto nowhere{ db.AddReference("", "", chest) };
+
+    fixture.WriteFile("Test_CID.ini", "[General]\n"
+                                      "Chest = IronSword|1|WhiterunLocation\n"
+                                      "Chest = Gold001|1@LocTypeCity\n");
+    Parser::ParseINIs();
+
+    // Location and keyword rules apply only where they match, and not at all without a current location
+    Distributor::Distribute(in_whiterun);
+    CHECK(CountOf(in_whiterun, sword) == 1);
+    CHECK(CountOf(in_whiterun, gold) == 1);
+
+    Distributor::Distribute(in_riverwood);
+    CHECK(in_riverwood->inventory.empty());
+
+    Distributor::Distribute(nowhere);
+    CHECK(nowhere->inventory.empty());
+}
+
+TEST(LeveledListCountsAddUp)
+{
+    Test::Fixture fixture{ "LeveledListCountsAddUp" };
+    auto&         db{ fixture.db };
+
+    const auto gold{ db.AddItem("Test.esp", "Gold001") };
+    const auto nested{ db.AddLeveledList("Test.esp", "LItemGoldNested", { { .form = gold, .count = 40'000, .level = 1 } }) };
+    db.AddLeveledList("Test.esp", "LItemGold", { { .form = gold, .count = 40'000, .level = 1 }, { .form = nested, .count = 1, .level = 1 } });
+    const auto chest_ref{ db.AddReference("", "", db.AddContainer("Test.esp", "Chest")) };
+
+    fixture.WriteFile("Test_CID.ini", "[General]\n"
+                                      "Chest = LItemGold|1\n");
+    Parser::ParseINIs();
+
+    // The same item out of the list and the nested one goes past what a u16 holds
+    Distributor::Distribute(chest_ref);
+    CHECK(CountOf(chest_ref, gold) == 80'000);
+}
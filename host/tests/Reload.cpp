@@ -0,0 +1,95 @@
+#include "Test.h"
+
+#include "Map.h"
+#include "Parser.h"
+#include "RuleTable.h"
+#include "Settings.h"
+
+namespace
+{
+    // Every rule of a container in table order, so a patched table can be compared to a frozen one
+    [[nodiscard]] std::string Describe(const RE::FormID form_id) noexcept
+    {
+        const auto rules{ RuleTable::Find(form_id) };
+        if (!rules) {
+            return "none";
+        }
+
+        std::string out{};
+        const auto  append{ [&](const FrozenRule& rule) { std::format_to(std::back_inserter(out), "{}|{}#{} ", rule.bound_object->editorID, rule.count, rule.index); } };
+        for (const auto& [unconditional, groups] : { rules->to_add, rules->to_add_leveled, rules->to_remove, rules->to_remove_all }) {
+            std::ranges::for_each(unconditional, append);
+            for (const auto& group : groups) {
+                std::ranges::for_each(group.rules, append);
+            }
+            out.push_back(';');
+        }
+
+        return out;
+    }
+} // namespace
+
+TEST(ReloadPatchesChangedFiles)
+{
+    Test::Fixture fixture{ "ReloadPatchesChangedFiles" };
+    auto&         db{ fixture.db };
+
+    const auto watch_inis{ Settings::watch_inis };
+    Settings::watch_inis = true;
+    Map::distr_map       = {};
+
+    db.AddItem("Test.esp", "IronSword");
+    db.AddItem("Test.esp", "Gold001");
+    db.AddItem("Test.esp", "Lockpick");
+    const auto chest{ db.AddContainer("Test.esp", "Chest")->GetFormID() };
+    const auto barrel{ db.AddContainer("Test.esp", "Barrel")->GetFormID() };
+    const auto sack{ db.AddContainer("Test.esp", "Sack")->GetFormID() };
+
+    fixture.WriteFile("B_CID.ini", "[General]\n"
+                                   "Chest = IronSword|1\n"
+                                   "Barrel = Gold001|5\n");
+    fixture.WriteFile("C_CID.ini", "[General]\n"
+                                   "Chest = Gold001|2\n"
+                                   "Chest = -Lockpick\n");
+    Parser::ParseINIs();
+
+    CHECK(Describe(chest) == "IronSword|1#0 Gold001|2#1 ;;;Lockpick|0#0 ;");
+    CHECK(Describe(barrel) == "Gold001|5#0 ;;;;");
+
+    // Editing a file keeps its place among the others
+    fixture.WriteFile("B_CID.ini", "[General]\n"
+                                   "Chest = IronSword|3\n"
+                                   "Sack = Lockpick|1\n");
+    Parser::ReloadINIs({ fixture.dir / "B_CID.ini" });
+
+    CHECK(Describe(chest) == "IronSword|3#0 Gold001|2#1 ;;;Lockpick|0#0 ;");
+    CHECK(Describe(barrel) == "none");
+    CHECK(Describe(sack) == "Lockpick|1#0 ;;;;");
+    CHECK(!RuleTable::MayContain(barrel) || !RuleTable::Find(barrel));
+    CHECK(RuleTable::MayContain(sack));
+
+    // A new file that sorts first goes before the files already loaded
+    fixture.WriteFile("A_CID.ini", "[General]\n"
+                                   "Chest = Lockpick|4\n"
+                                   "Barrel = IronSword|1\n");
+    Parser::ReloadINIs({ fixture.dir / "A_CID.ini" });
+
+    CHECK(Describe(chest) == "Lockpick|4#0 IronSword|3#1 Gold001|2#2 ;;;Lockpick|0#0 ;");
+    CHECK(Describe(barrel) == "IronSword|1#0 ;;;;");
+
+    // A deleted file contributes nothing
+    std::filesystem::remove(fixture.dir / "C_CID.ini");
+    Parser::ReloadINIs({ fixture.dir / "C_CID.ini" });
+
+    CHECK(Describe(chest) == "Lockpick|4#0 IronSword|3#1 ;;;;");
+
+    // The patched table matches a full parse of the same files
+    const std::array described{ Describe(chest), Describe(barrel), Describe(sack) };
+    Map::distr_map = {};
+    Parser::ParseINIs();
+    CHECK(described == (std::array{ Describe(chest), Describe(barrel), Describe(sack) }));
+    CHECK(RuleTable::Size() == 3);
+
+    Map::distr_map       = {};
+    Settings::watch_inis = watch_inis;
+}
@@ -0,0 +1,113 @@
+#include "Test.h"
+
+#include "Distributor.h"
+#include "Map.h"
+#include "Parser.h"
+#include "Scheduler.h"
+
+TEST(SchedulerWaitsFor3D)
+{
+    Test::Fixture fixture{ "SchedulerWaitsFor3D" };
+    auto&         db{ fixture.db };
+
+    const auto sword{ db.AddItem("Test.esp", "IronSword") };
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+    const auto loading_ref{ db.AddReference("", "", chest) };
+    const auto detached_ref{ db.AddReference("", "", chest) };
+
+    fixture.WriteFile("Test_CID.ini", "[General]\nChest = IronSword|1\n");
+    Parser::ParseINIs();
+
+    loading_ref->loaded3D  = false;
+    detached_ref->loaded3D = false;
+    detached_ref->detached = true;
+
+    Scheduler::Enqueue(loading_ref);
+    Scheduler::Enqueue(detached_ref);
+
+    // The 3D is still loading in the background, so the ref waits in the queue while the detached one is dropped
+    Scheduler::RunFrame();
+    CHECK(Scheduler::QueueDepth() == 1);
+    CHECK(loading_ref->inventory.empty());
+
+    loading_ref->loaded3D = true;
+    Scheduler::RunFrame();
+    CHECK(Scheduler::QueueDepth() == 0);
+    CHECK(loading_ref->inventory[sword] == 1);
+    CHECK(detached_ref->inventory.empty());
+}
+
+TEST(SchedulerDropsUnloadedRefs)
+{
+    Test::Fixture fixture{ "SchedulerDropsUnloadedRefs" };
+    auto&         db{ fixture.db };
+
+    db.AddItem("Test.esp", "IronSword");
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+    const auto unloaded_ref{ db.AddReference("", "", chest) };
+    const auto other_ref{ db.AddReference("", "", chest) };
+
+    fixture.WriteFile("Test_CID.ini", "[General]\nChest = IronSword|1\n");
+    Parser::ParseINIs();
+
+    // 3D that never arrives is given up on instead of being queued again every frame
+    unloaded_ref->loaded3D = false;
+    Scheduler::Enqueue(unloaded_ref);
+    for (u32 i{}; i < Scheduler::max_frames_waited; ++i) {
+        Scheduler::RunFrame();
+    }
+    CHECK(Scheduler::QueueDepth() == 1);
+    Scheduler::RunFrame();
+    CHECK(Scheduler::QueueDepth() == 0);
+    CHECK(unloaded_ref->inventory.empty());
+
+    // Loading a save drops whatever the previous game queued
+    Scheduler::Enqueue(other_ref);
+    CHECK(Scheduler::QueueDepth() == 1);
+    Scheduler::Clear();
+    CHECK(Scheduler::QueueDepth() == 0);
+    Scheduler::RunFrame();
+    CHECK(other_ref->inventory.empty());
+}
+
+TEST(ResetInventoryTracking)
+{
+    Test::Fixture fixture{ "ResetInventoryTracking" };
+    auto&         db{ fixture.db };
+
+    const auto sword{ db.AddItem("Test.esp", "IronSword") };
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+    const auto ref{ db.AddReference("", "", chest) };
+    const auto respawn_ref{ db.AddReference("", "", chest) };
+
+    fixture.WriteFile("Test_CID.ini", "[General]\nChest = IronSword|1\n");
+    Parser::ParseINIs();
+
+    Map::respawn_containers.Insert(respawn_ref->GetFormID());
+
+    Distributor::Distribute(ref);
+    Distributor::Distribute(respawn_ref);
+    CHECK(Map::added_objects.Contains(ref->GetFormID()));
+
+    // A leveled-only reset leaves the distributed sword in place, so it must stay tracked and out of the save
+    Scheduler::OnResetInventory(ref, true);
+    CHECK(Map::added_objects.Contains(ref->GetFormID()));
+    CHECK(Map::processed_containers.Contains(ref->GetFormID()));
+
+    // A full reset drops it, and a container that does not respawn is not distributed again
+    ref->inventory.clear();
+    Scheduler::OnResetInventory(ref, false);
+    CHECK(!Map::added_objects.Contains(ref->GetFormID()));
+    CHECK(Map::processed_containers.Contains(ref->GetFormID()));
+    CHECK(Scheduler::QueueDepth() == 0);
+
+    // A respawning container is distributed again, and tracked again with it
+    respawn_ref->inventory.clear();
+    Scheduler::OnResetInventory(respawn_ref, false);
+    CHECK(!Map::added_objects.Contains(respawn_ref->GetFormID()));
+    CHECK(Scheduler::QueueDepth() == 1);
+
+    Scheduler::RunFrame();
+    CHECK(respawn_ref->inventory[sword] == 1);
+    CHECK(Map::added_objects.Contains(respawn_ref->GetFormID()));
+}
@@ -0,0 +1,128 @@
+#include "Test.h"
+
+#include "Distributor.h"
+#include "Map.h"
+#include "Parser.h"
+
+namespace
+{
+    [[nodiscard]] u32 ThreadCount() noexcept { return std::max(std::thread::hardware_concurrency(), 4U); }
+
+    // Runs func(thread index) on every thread at once
+    template <typename F>
+    void RunConcurrently(const u32 threads, F&& func) noexcept
+    {
+        std::latch                start{ threads };
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (u32 t{}; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                start.arrive_and_wait();
+                func(t);
+            });
+        }
+    }
+} // namespace
+
+TEST(ShardedSetClaimsOnce)
+{
+    constexpr u32 keys{ 50'000 };
+
+    ShardedSet<RE::FormID>        set;
+    std::vector<std::atomic<u32>> claims(keys);
+    const auto                    threads{ ThreadCount() };
+
+    // Every thread claims every key, starting at a different offset so threads collide on keys and shards
+    RunConcurrently(threads, [&](const u32 t) {
+        for (u32 i{}; i < keys; ++i) {
+            const auto key{ (i + t * keys / threads) % keys };
+            if (set.Insert(key)) {
+                claims[key].fetch_add(1, std::memory_order_relaxed);
+            }
+            static_cast<void>(set.Contains(key));
+        }
+    });
+
+    CHECK(set.Size() == keys);
+    CHECK(std::ranges::all_of(claims, [](const std::atomic<u32>& c) { return c.load() == 1; }));
+
+    // Erase and claim again from every thread at once, on interleaved keys
+    std::atomic<bool> reclaimed{ true };
+    RunConcurrently(threads, [&](const u32 t) {
+        for (u32 key{ t }; key < keys; key += threads) {
+            if (!set.Erase(key) || !set.Insert(key)) {
+                reclaimed = false;
+            }
+        }
+    });
+    CHECK(reclaimed);
+    CHECK(set.Size() == keys);
+}
+
+TEST(AddedObjectsUnderContention)
+{
+    constexpr u32 refs_per_thread{ 2'000 };
+    constexpr u32 objects_per_ref{ 8 };
+
+    AddedObjects added;
+    const auto   threads{ ThreadCount() };
+
+    // Each thread owns its refs, but they share shards and slabs with every other thread's. Erasing every other ref frees nodes the next adds reuse
+    RunConcurrently(threads, [&](const u32 t) {
+        for (u32 round{}; round < 2; ++round) {
+            for (u32 i{}; i < refs_per_thread; ++i) {
+                const auto ref{ t * refs_per_thread + i };
+                for (u32 obj{}; obj < objects_per_ref; ++obj) {
+                    added.Add(ref, obj, 1);
+                }
+                if (round == 0 && i % 2 == 0) {
+                    added.Erase(ref);
+                }
+            }
+        }
+    });
+
+    CHECK(added.Size() == threads * refs_per_thread);
+
+    bool counts_match{ true };
+    for (u32 ref{}; ref < threads * refs_per_thread; ++ref) {
+        u32 records{};
+        added.ForEach(ref, [&](const AddedObjects::Record& record) {
+            ++records;
+            counts_match &= record.count == (ref % refs_per_thread % 2 == 0 ? 1U : 2U);
+        });
+        counts_match &= records == objects_per_ref;
+    }
+    CHECK(counts_match);
+}
+
+TEST(ConcurrentDistributeOncePerRef)
+{
+    constexpr u32 ref_count{ 5'000 };
+
+    Test::Fixture fixture{ "ConcurrentDistributeOncePerRef" };
+    auto&         db{ fixture.db };
+
+    const auto sword{ db.AddItem("Test.esp", "IronSword") };
+    const auto chest{ db.AddContainer("Test.esp", "Chest") };
+
+    std::vector<RE::TESObjectREFR*> refs;
+    refs.reserve(ref_count);
+    for (u32 i{}; i < ref_count; ++i) {
+        refs.emplace_back(db.AddReference("", "", chest));
+    }
+
+    fixture.WriteFile("Test_CID.ini", "[General]\nChest = IronSword|1\n");
+    Parser::ParseINIs();
+
+    // Like Load3D on several background loading threads at once, every thread tries every ref
+    RunConcurrently(ThreadCount(), [&](const u32 t) {
+        for (u32 i{}; i < ref_count; ++i) {
+            Distributor::Distribute(refs[(i + t * 7919) % ref_count]);
+        }
+    });
+
+    CHECK(Map::processed_containers.Size() == ref_count);
+    CHECK(Map::added_objects.Size() == ref_count);
+    CHECK(std::ranges::all_of(refs, [&](const RE::TESObjectREFR* ref) { return ref->inventory.size() == 1 && ref->inventory.at(sword) == 1; }));
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "FormDatabase.h"
+
+// Just enough of a test harness to run the rule engine on the stand-in form database under ctest
+namespace Test
+{
+    struct Case
+    {
+        std::string_view name{};
+        void (*func)(){};
+    };
+
+    inline std::vector<Case>& Cases() noexcept
+    {
+        static std::vector<Case> cases;
+
+        return cases;
+    }
+
+    inline u32 failures{};
+
+    struct Register
+    {
+        Register(const std::string_view name, void (*func)()) noexcept { Cases().emplace_back(name, func); }
+    };
+
+    inline void Check(const bool passed, const std::string_view expression, const std::source_location location = std::source_location::current()) noexcept
+    {
+        if (!passed) {
+            ++failures;
+            spdlog::error("{}:{}: CHECK({}) failed", location.file_name(), location.line(), expression);
+        }
+    }
+
+    // Fresh database with one plugin, and a Data directory of its own for the _CID.ini and plugin files a test writes
+    class Fixture
+    {
+    public:
+        FormDatabase&         db{ FormDatabase::Get() };
+        std::filesystem::path dir{};
+
+        explicit Fixture(std::string_view name) noexcept;
+
+        ~Fixture() noexcept;
+
+        Fixture(const Fixture&)            = delete;
+        Fixture& operator=(const Fixture&) = delete;
+
+        void WriteFile(std::string_view filename, std::string_view text) const noexcept;
+    };
+} // namespace Test
+
+#define CID_CONCAT_IMPL(a, b) a##b
+#define CID_CONCAT(a, b)      CID_CONCAT_IMPL(a, b)
+
+#define TEST(name)                                                                    \
+    static void       name();                                                         \
+    static const auto CID_CONCAT(name, _registered){ Test::Register{ #name, name } }; \
+    static void       name()
+
+#define CHECK(expression) Test::Check(static_cast<bool>(expression), #expression)
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ankerl/unordered_dense.h"
+
+// Objects distributed to each container ref, keyed by the ref's FormID. The first few objects of a ref live inline in its entry, the rest in linked nodes of a slab whose
+// freed nodes are reused. Refs are spread over independently locked shards, each with its own slab
+class AddedObjects
+{
+public:
+    struct Record
+    {
+        RE::FormID obj{};
+        u32        count{};
+    };
+
+private:
+    static constexpr u32         inline_capacity{ 3 };
+    static constexpr u32         npos{ std::numeric_limits<u32>::max() };
+    static constexpr std::size_t shard_count{ 16 };
+
+    struct Node
+    {
+        Record record{};
+        u32    next{ npos };
+    };
+
+    struct Entry
+    {
+        std::array<Record, inline_capacity> records{};
+        u32                                 size{};
+        u32                                 overflow{ npos };
+    };
+
+    struct alignas(64) Shard
+    {
+        mutable std::mutex                              lock{};
+        ankerl::unordered_dense::map<RE::FormID, Entry> entries{};
+        std::vector<Node>                               slab{};
+        u32                                             free_head{ npos };
+        u32                                             free_nodes{};
+
+        [[nodiscard]] u32 AllocateNode(const Record& record) noexcept;
+    };
+
+    std::array<Shard, shard_count> shards{};
+
+    [[nodiscard]] Shard& GetShard(const RE::FormID ref) noexcept { return shards[ankerl::unordered_dense::hash<RE::FormID>{}(ref) % shard_count]; }
+
+    [[nodiscard]] const Shard& GetShard(const RE::FormID ref) const noexcept { return shards[ankerl::unordered_dense::hash<RE::FormID>{}(ref) % shard_count]; }
+
+    void CopyRecords(RE::FormID ref, std::vector<Record>& out) const noexcept;
+
+public:
+    void Add(RE::FormID ref, RE::FormID obj, u32 count) noexcept;
+
+    // func runs after the shard lock is released, so it may call back into the engine
+    template <typename F>
+    void ForEach(const RE::FormID ref, F&& func) const noexcept
+    {
+        thread_local std::vector<Record> records;
+        CopyRecords(ref, records);
+
+        for (const auto& record : records) {
+            func(record);
+        }
+    }
+
+    [[nodiscard]] bool Contains(RE::FormID ref) const noexcept;
+
+    void Erase(RE::FormID ref) noexcept;
+
+    void Clear() noexcept;
+
+    [[nodiscard]] std::size_t Size() const noexcept;
+
+    [[nodiscard]] u32 FreeNodes() const noexcept;
+
+    [[nodiscard]] std::size_t MemoryUsage() const noexcept;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Map.h"
+
+class Cache
+{
+    static constexpr u32 magic{ 0x43444943 }; // "CIDC"
+    static constexpr u32 version{ 2 };
+
+    struct Header
+    {
+        u32 magic{};
+        u32 version{};
+        u64 fingerprint{};
+        u64 rule_count{};
+    };
+
+    struct Record
+    {
+        RE::FormID container_form_id{};
+        RE::FormID bound_object{};
+        RE::FormID location{};
+        RE::FormID location_keyword{};
+        u16        count{};
+        u16        chance{};
+        DistrType  type{};
+        u8         pad{};
+        u16        file{};
+    };
+    static_assert(sizeof(Record) == 24);
+
+    [[nodiscard]] static std::filesystem::path GetPath() noexcept;
+
+public:
+    // Hash of the active plugin list (names, load order slots, file sizes and write times) and of the name and contents of every _CID.ini file
+    [[nodiscard]] static u64 Fingerprint(const std::vector<std::filesystem::path>& cid_inis) noexcept;
+
+    [[nodiscard]] static std::optional<std::vector<DistrObject>> Load(u64 fingerprint) noexcept;
+
+    static void Save(u64 fingerprint, const std::vector<std::vector<DistrObject>>& rules_per_file) noexcept;
+};
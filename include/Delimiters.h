@@ -0,0 +1,65 @@
+#pragma once
+
+enum struct Delimiter : u8 { Bar, Question, At, Count };
+
+// Where every rule delimiter sits in one value: bit i of a delimiter's mask is set when s[i] is that delimiter. Built in a single pass, 32 or 16 bytes at a time where
+// the CPU allows, so classification and tokenization never walk the value again
+class DelimiterMask
+{
+    std::array<std::vector<u64>, std::to_underlying(Delimiter::Count)> masks{};
+
+    std::size_t size{};
+
+    [[nodiscard]] const std::vector<u64>& Get(const Delimiter d) const noexcept { return masks[std::to_underlying(d)]; }
+
+    // Bits [begin, end) of word w
+    [[nodiscard]] static constexpr u64 RangeBits(const std::size_t w, const std::size_t begin, const std::size_t end) noexcept
+    {
+        const auto lo{ w * 64 < begin ? begin - w * 64 : 0 };
+        const auto hi{ std::min<std::size_t>(end - w * 64, 64) };
+
+        return (hi == 64 ? ~0ULL : (1ULL << hi) - 1) & ~((1ULL << lo) - 1);
+    }
+
+public:
+    void Scan(std::string_view s) noexcept;
+
+    // Reference implementation, also used for the tail and on CPUs without SSE2
+    void ScanScalar(std::string_view s) noexcept;
+
+    [[nodiscard]] std::size_t Size() const noexcept { return size; }
+
+    [[nodiscard]] std::size_t Count(const Delimiter d, const std::size_t begin, const std::size_t end) const noexcept
+    {
+        std::size_t count{};
+        for (auto w{ begin / 64 }; begin < end && w <= (end - 1) / 64; ++w) {
+            count += std::popcount(Get(d)[w] & RangeBits(w, begin, end));
+        }
+
+        return count;
+    }
+
+    // First position of d in [begin, end), or npos
+    [[nodiscard]] std::size_t Find(const Delimiter d, const std::size_t begin, const std::size_t end) const noexcept
+    {
+        for (auto w{ begin / 64 }; begin < end && w <= (end - 1) / 64; ++w) {
+            if (const auto bits{ Get(d)[w] & RangeBits(w, begin, end) }) {
+                return w * 64 + std::countr_zero(bits);
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
+    // Last position of d in [begin, end), or npos
+    [[nodiscard]] std::size_t RFind(const Delimiter d, const std::size_t begin, const std::size_t end) const noexcept
+    {
+        for (auto w{ begin < end ? (end - 1) / 64 + 1 : 0 }; w-- > begin / 64;) {
+            if (const auto bits{ Get(d)[w] & RangeBits(w, begin, end) }) {
+                return w * 64 + 63 - std::countl_zero(bits);
+            }
+        }
+
+        return std::string_view::npos;
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "RuleTable.h"
+
+enum struct DistrEvent : u8 { Add, Remove, RemoveAll, LeveledList, LeveledListEntry, LeveledListEnd };
+
+// Raw distribution result. Only FormIDs and numbers, so recording one costs a copy and all formatting happens on the log thread. References can be deleted before it
+// gets there, so it never looks forms up: rule forms are named from the EditorIDs table, everything else by FormID
+struct DistrRecord
+{
+    DistrEvent type{};
+    u16        chance{};
+    u16        rule_count{};
+    u32        count{};
+    RE::FormID ref{};
+    RE::FormID container{}; // The reference or base object the rule was written for
+    RE::FormID object{};
+    RE::FormID location{};
+    RE::FormID location_keyword{};
+};
+
+class DistrLog
+{
+    static constexpr std::size_t capacity{ 4096 };
+
+    inline static std::array<DistrRecord, capacity> ring{};
+
+    inline static std::size_t head{};
+
+    inline static std::size_t size{};
+
+    inline static std::size_t dropped{};
+
+    inline static std::mutex lock{};
+
+    inline static std::condition_variable cv{};
+
+    static void Run() noexcept;
+
+    static void Write(const DistrRecord& record) noexcept;
+
+public:
+    static void Start() noexcept;
+
+    [[nodiscard]] static bool Enabled() noexcept { return spdlog::default_logger_raw()->should_log(spdlog::level::info); }
+
+    static void Push(const DistrRecord& record) noexcept
+    {
+        if (!Enabled()) {
+            return;
+        }
+
+        {
+            std::scoped_lock l{ lock };
+            if (size == capacity) {
+                ++dropped;
+                return;
+            }
+            ring[(head + size++) % capacity] = record;
+        }
+        cv.notify_one();
+    }
+
+    // count is what the rule changed, which differs from the rule's own count for remove-all. Main thread, since it interns the editor IDs the log thread names
+    // the rule's forms by
+    static void Push(const DistrEvent type, const RE::FormID ref, const RE::FormID container, const FrozenRule& rule, const u32 count) noexcept
+    {
+        if (!Enabled()) {
+            return;
+        }
+
+        const auto& [bound_object, location, location_keyword, rule_count, chance, index]{ rule };
+        EditorIDs::Intern(bound_object);
+        EditorIDs::Intern(location);
+        EditorIDs::Intern(location_keyword);
+        Push({ .type             = type,
+               .chance           = chance,
+               .rule_count       = rule_count,
+               .count            = count,
+               .ref              = ref,
+               .container        = container,
+               .object           = bound_object->GetFormID(),
+               .location         = location ? location->GetFormID() : 0x0U,
+               .location_keyword = location_keyword ? location_keyword->GetFormID() : 0x0U });
+    }
+};
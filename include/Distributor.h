@@ -1,7 +1,63 @@
 #pragma once
 
+#include "RuleTable.h"
+
 class Distributor
 {
+    // Net effect of every rule on one object, in rule order: all adds, then removes (clamped at zero), then remove-all
+    struct ObjectDelta
+    {
+        RE::TESBoundObject* obj{};
+        i32                 added{};
+        i32                 removed{};
+        bool                remove_all{};
+    };
+
+    // The container's current location and its keywords, queried once per Distribute call and only if the container has location-conditioned rules
+    class LocationContext
+    {
+        RE::TESObjectREFR*       ref{};
+        RE::FormID               location{};
+        std::vector<RE::FormID>& keywords;
+        bool                     resolved{};
+
+        void Resolve() noexcept;
+
+    public:
+        LocationContext(RE::TESObjectREFR* a_ref, std::vector<RE::FormID>& a_keywords) noexcept : ref(a_ref), keywords(a_keywords) {}
+
+        // A location group matches only in that exact location, and a keyword group only where the location has the keyword. Without a current location, nothing matches
+        [[nodiscard]] bool Matches(const RuleGroup& group) noexcept;
+    };
+
+    // Stage 1 state of one Distribute call: the net delta per object, and an inventory snapshot taken the first time a removal needs the container's count
+    class Plan
+    {
+        RE::TESObjectREFR*                                      ref{};
+        std::vector<ObjectDelta>&                               deltas;
+        ankerl::unordered_dense::map<RE::TESBoundObject*, u32>& delta_indices;
+        std::optional<RE::TESObjectREFR::InventoryCountMap>     inv_map{};
+
+    public:
+        u32 inventory_scans{};
+
+        Plan(RE::TESObjectREFR* a_ref, std::vector<ObjectDelta>& a_deltas, ankerl::unordered_dense::map<RE::TESBoundObject*, u32>& a_delta_indices) noexcept :
+            ref(a_ref), deltas(a_deltas), delta_indices(a_delta_indices)
+        {}
+
+        [[nodiscard]] ObjectDelta& GetDelta(RE::TESBoundObject* obj) noexcept;
+
+        [[nodiscard]] i32 GetInventoryCount(RE::TESBoundObject* obj) noexcept;
+    };
+
+    // Calls func for the unconditional rules and the groups matching the container's location, in parse order
+    template <typename F>
+    static void ForEachRule(const TypedRules& typed_rules, LocationContext& location_context, F&& func) noexcept;
+
+    // One kernel per rule category. The rule table already split them, so nothing but the chance roll is decided per rule
+    template <DistrType type, bool leveled>
+    static void RunKernel(RE::TESObjectREFR* ref, RE::FormID container, const TypedRules& typed_rules, LocationContext& location_context, Plan& plan) noexcept;
+
 public:
     static void Distribute(RE::TESObjectREFR* a_ref) noexcept;
 };
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ankerl/unordered_dense.h"
+
+// Editor IDs of the forms rules reference, looked up the first time one is formatted and then kept, so logging rules does not call into po3_Tweaks for each line.
+// Every other form, like references and leveled list entries, is looked up each time: dynamic FormIDs get reused, and keeping them would grow the table all session
+class EditorIDs
+{
+    inline static ankerl::unordered_dense::map<RE::FormID, std::string> table{};
+
+    inline static ankerl::unordered_dense::set<RE::FormID> rule_forms{};
+
+    inline static std::shared_mutex lock{};
+
+public:
+    // Replaces the forms that may be interned and empties the table, so it never holds more than the current rules name
+    static void SetRuleForms(std::span<const RE::FormID> form_ids) noexcept;
+
+    // Adds forms that may be interned, keeping the table
+    static void AddRuleForms(std::span<const RE::FormID> form_ids) noexcept;
+
+    [[nodiscard]] static std::string Get(const RE::TESForm* form) noexcept;
+
+    // Looks up a rule form's editor ID now if it is not interned yet, so Find has it later. Does nothing for other forms
+    static void Intern(const RE::TESForm* form) noexcept;
+
+    // Only what is already interned. Never calls into the game, so it is safe off the main thread
+    [[nodiscard]] static std::optional<std::string> Find(RE::FormID form_id) noexcept;
+
+    [[nodiscard]] static std::size_t Size() noexcept;
+
+    [[nodiscard]] static std::size_t MemoryUsage() noexcept;
+};
@@ -7,4 +7,17 @@ namespace Events
     public:
         RE::BSEventNotifyControl ProcessEvent(const RE::TESLoadGameEvent* a_event, RE::BSTEventSource<RE::TESLoadGameEvent>* a_eventSource) noexcept override;
     };
+
+    class FormDeleteEventHandler final : public EventHandler<FormDeleteEventHandler, RE::TESFormDeleteEvent>
+    {
+    public:
+        RE::BSEventNotifyControl ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>* a_eventSource) noexcept override;
+    };
+
+    // Loot menus like QuickLoot show a container's inventory as soon as it is under the crosshair, without activating it
+    class CrosshairRefEventHandler final : public EventHandler<CrosshairRefEventHandler, SKSE::CrosshairRefEvent>
+    {
+    public:
+        RE::BSEventNotifyControl ProcessEvent(const SKSE::CrosshairRefEvent* a_event, RE::BSTEventSource<SKSE::CrosshairRefEvent>* a_eventSource) noexcept override;
+    };
 } // namespace Events
@@ -0,0 +1,63 @@
+#pragma once
+
+struct ObjectAndCount;
+
+struct PluginInfo
+{
+    std::string name{};
+    u8          compile_index{};
+    u16         small_file_compile_index{};
+    bool        is_light{};
+};
+
+// Everything the rule engine asks of the game. The plugin implements it on CommonLibSSE in src/Game.cpp, the host build on the stand-in form database in
+// host/src/Game.cpp, so parsing, resolution and distribution build and run outside the game
+class Game
+{
+public:
+    [[nodiscard]] static RE::TESForm* LookupByID(RE::FormID form_id) noexcept;
+
+    template <typename T>
+    [[nodiscard]] static T* LookupByID(const RE::FormID form_id) noexcept
+    {
+        if (const auto form{ LookupByID(form_id) }) {
+            return form->As<T>();
+        }
+
+        return nullptr;
+    }
+
+    // editor_id need not be NUL-terminated
+    [[nodiscard]] static RE::TESForm* LookupByEditorID(std::string_view editor_id) noexcept;
+
+    [[nodiscard]] static const char* GetEditorID(const RE::TESForm* form) noexcept;
+
+    // Loaded plugins in load order, without the ones that have no compile index
+    [[nodiscard]] static std::vector<PluginInfo> GetPlugins() noexcept;
+
+    // Appends what leveled_list gives at the player's current level, count times, without merging duplicates
+    static void CalculateLeveledList(RE::TESLevItem* leveled_list, u32 count, std::vector<ObjectAndCount>& out) noexcept;
+
+    [[nodiscard]] static RE::BGSLocation* GetCurrentLocation(RE::TESObjectREFR* ref) noexcept;
+
+    [[nodiscard]] static RE::TESObjectREFR::InventoryCountMap GetInventoryCounts(RE::TESObjectREFR* ref) noexcept;
+
+    static void AddObject(RE::TESObjectREFR* ref, RE::TESBoundObject* obj, i32 count) noexcept;
+
+    static void RemoveObject(RE::TESObjectREFR* ref, RE::TESBoundObject* obj, i32 count) noexcept;
+
+    [[nodiscard]] static bool Is3DLoaded(const RE::TESObjectREFR* ref) noexcept;
+
+    // Deleted, disabled, or in a cell that is no longer attached, so its 3D is not coming. Loading it again goes through Load3D
+    [[nodiscard]] static bool IsDetached(const RE::TESObjectREFR* ref) noexcept;
+
+    [[nodiscard]] static std::filesystem::path GetDataDirectory() noexcept;
+
+    [[nodiscard]] static std::optional<std::filesystem::path> GetLogDirectory() noexcept;
+
+    [[nodiscard]] static std::string_view GetPluginName() noexcept;
+
+    [[nodiscard]] static std::string GetPluginVersion() noexcept;
+
+    [[noreturn]] static void Fail(std::string_view message) noexcept;
+};
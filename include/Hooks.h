@@ -43,4 +43,36 @@ namespace Hooks
 
         static constexpr std::size_t idx{ 14 }; // 0xe
     };
+
+    class PlayerUpdate
+    {
+    public:
+        static void Thunk(RE::PlayerCharacter* a_this, float a_delta) noexcept;
+
+        inline static REL::Relocation<decltype(&Thunk)> func;
+
+        static constexpr std::size_t idx{ 173 }; // 0xad
+    };
+
+    class ActivateContainer
+    {
+    public:
+        static bool Thunk(RE::TESObjectCONT* a_this, RE::TESObjectREFR* a_targetRef, RE::TESObjectREFR* a_activatorRef, u8 a_arg3, RE::TESBoundObject* a_object,
+                          i32 a_targetCount) noexcept;
+
+        inline static REL::Relocation<decltype(&Thunk)> func;
+
+        static constexpr std::size_t idx{ 55 }; // 0x37
+    };
+
+    class ActivateActor
+    {
+    public:
+        static bool Thunk(RE::TESNPC* a_this, RE::TESObjectREFR* a_targetRef, RE::TESObjectREFR* a_activatorRef, u8 a_arg3, RE::TESBoundObject* a_object,
+                          i32 a_targetCount) noexcept;
+
+        inline static REL::Relocation<decltype(&Thunk)> func;
+
+        static constexpr std::size_t idx{ 55 }; // 0x37
+    };
 } // namespace Hooks
@@ -0,0 +1,21 @@
+#pragma once
+
+struct KeyValue
+{
+    std::string_view key{};
+    std::string_view value{};
+};
+
+class Lexer
+{
+public:
+    [[nodiscard]] static bool LoadFile(const std::filesystem::path& path, std::vector<char>& buffer) noexcept;
+
+    // Collects every key/value pair of the [General] section in the order CSimpleIniA's multi-key mode reported them: keys compared case-insensitively and sorted, values in
+    // load order. All views point into text.
+    [[nodiscard]] static std::vector<KeyValue> LexGeneral(std::string_view text) noexcept;
+
+    [[nodiscard]] static std::string_view Trim(std::string_view s) noexcept;
+
+    [[nodiscard]] static int CompareNoCase(std::string_view lhs, std::string_view rhs) noexcept;
+};
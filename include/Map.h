@@ -1,18 +1,21 @@
 #pragma once
 
+#include "AddedObjects.h"
+#include "EditorIDs.h"
+#include "ShardedSet.h"
 #include "ankerl/unordered_dense.h"
 
 enum struct DistrType : u8 { Add, Remove, RemoveAll, Error };
 
 struct DistrToken
 {
-    DistrType   type{};
-    std::string to_identifier{};
-    std::string identifier{};
-    u16         count{};
-    std::string location{};
-    std::string location_keyword{};
-    u16         chance{};
+    DistrType        type{};
+    std::string_view to_identifier{};
+    std::string_view identifier{};
+    u16              count{};
+    std::string_view location{};
+    std::string_view location_keyword{};
+    u16              chance{};
 };
 
 struct DistrObject
@@ -24,18 +27,19 @@ struct DistrObject
     RE::BGSLocation*    location{};
     RE::BGSKeyword*     location_keyword{};
     u16                 chance{};
+    u16                 file{}; // Index into Map::source_files
 };
 
 struct FormIDAndPluginName
 {
-    RE::FormID  form_id{};
-    std::string plugin_name{};
+    RE::FormID       form_id{};
+    std::string_view plugin_name{};
 };
 
 struct ObjectAndCount
 {
     RE::TESBoundObject* obj{};
-    u16                 count{};
+    u32                 count{}; // Summed over entries and nested lists, so it can outgrow a rule's count
 };
 
 using TDistrVec = std::vector<DistrObject>;
@@ -52,69 +56,56 @@ class Map
     template <typename K, typename V>
     using map = ankerl::unordered_dense::map<K, V>;
 
-    template <typename K>
-    using set = ankerl::unordered_dense::set<K>;
-
 public:
-    [[nodiscard]] static auto ToFormID(const std::string& s) noexcept { return static_cast<RE::FormID>(std::stoul(s, nullptr, 16)); }
+    [[nodiscard]] static std::optional<RE::FormID> ToFormID(std::string_view s) noexcept
+    {
+        if (s.starts_with("0x") || s.starts_with("0X")) {
+            s.remove_prefix(2);
+        }
+
+        RE::FormID form_id{};
+        if (const auto [ptr, ec]{ std::from_chars(s.data(), s.data() + s.size(), form_id, 16) }; ec != std::errc{} || ptr != s.data() + s.size() || s.empty()) {
+            return std::nullopt;
+        }
 
-    [[nodiscard]] static auto ToUnsignedInt(const std::string& s) noexcept { return static_cast<u16>(std::stoul(s)); }
+        return form_id;
+    }
+
+    [[nodiscard]] static std::optional<u16> ToUnsignedInt(const std::string_view s) noexcept
+    {
+        u16 value{};
+        if (const auto [ptr, ec]{ std::from_chars(s.data(), s.data() + s.size(), value) }; ec != std::errc{} || ptr != s.data() + s.size() || s.empty()) {
+            return std::nullopt;
+        }
+
+        return value;
+    }
 
     inline static map<RE::FormID, DistrVecs> distr_map{};
 
-    inline static map<RE::TESObjectREFR*, std::vector<ObjectAndCount>> added_objects{};
+    [[nodiscard]] static std::size_t DistrMapMemoryUsage() noexcept
+    {
+        std::size_t bytes{ distr_map.bucket_count() * sizeof(u64) + distr_map.values().capacity() * sizeof(decltype(distr_map)::value_type) };
+        for (const auto& [form_id, distr_vecs] : distr_map) {
+            bytes += (distr_vecs.to_add.capacity() + distr_vecs.to_remove.capacity() + distr_vecs.to_remove_all.capacity()) * sizeof(DistrObject);
+        }
+
+        return bytes;
+    }
+
+    // Every _CID.ini that contributed rules, indexed by DistrObject::file. Entries are never reused, so removed files keep their slot
+    inline static std::vector<std::filesystem::path> source_files{};
+
+    inline static AddedObjects added_objects{};
 
-    inline static set<RE::FormID> processed_containers{};
+    inline static ShardedSet<RE::FormID> processed_containers{};
 
-    inline static set<RE::FormID> respawn_containers{};
+    inline static ShardedSet<RE::FormID> respawn_containers{};
 };
 
 [[nodiscard]] inline std::string GetFormEditorID(const RE::TESForm* form) noexcept
 {
-    if (!form) {
-        return "";
-    }
-
-    using TGetFormEditorID = const char* (*)(u32);
-
-    using enum RE::FormType;
-    switch (form->GetFormType()) {
-    case Keyword:
-    case LocationRefType:
-    case Action:
-    case MenuIcon:
-    case Global:
-    case HeadPart:
-    case Race:
-    case Sound:
-    case Script:
-    case Navigation:
-    case Cell:
-    case WorldSpace:
-    case Land:
-    case NavMesh:
-    case Dialogue:
-    case Quest:
-    case Idle:
-    case AnimatedObject:
-    case ImageAdapter:
-    case VoiceType:
-    case Ragdoll:
-    case DefaultObject:
-    case MusicType:
-    case StoryManagerBranchNode:
-    case StoryManagerQuestNode:
-    case StoryManagerEventNode:
-    case SoundRecord:            return form->GetFormEditorID();
-    default:                     {
-        static auto po3_tweaks{ REX::W32::GetModuleHandleW(L"po3_Tweaks") };
-        static auto func{ reinterpret_cast<TGetFormEditorID>(REX::W32::GetProcAddress(po3_tweaks, "GetFormEditorID")) };
-        if (func) {
-            return func(form->formID);
-        }
-        return "";
-    }
-    }
+    return EditorIDs::Get(form);
 }
 
 template <>
@@ -156,7 +147,7 @@ struct std::formatter<DistrObject> : std::formatter<std::string_view>
     template <typename FmtContext>
     auto format(const DistrObject& obj, FmtContext& ctx) const
     {
-        const auto& [type, container_form_id, bound_object, count, location, location_keyword, chance]{ obj };
+        const auto& [type, container_form_id, bound_object, count, location, location_keyword, chance, file]{ obj };
         const auto formatted{ std::format("[Type: {} / Container: {:#x} / Bound object: {} ({:#x}) / Count: {} / Location: {} ({:#x}) / Location keyword: {} ({:#x}) / Chance: {}]",
                                           type, container_form_id, GetFormEditorID(bound_object), bound_object ? bound_object->GetFormID() : 0x0U, count, GetFormEditorID(location),
                                           location ? location->GetFormID() : 0x0U, GetFormEditorID(location_keyword), location_keyword ? location_keyword->GetFormID() : 0x0U,
@@ -0,0 +1,75 @@
+#pragma once
+
+// Diagnostics of the _CID.ini file being parsed. ParseINIs reads and resolves files on parallel tasks, so each task captures its file's messages and they are
+// written in sorted file order during the merge. Without a capture on the calling thread, messages go straight to the log
+class ParseLog
+{
+public:
+    struct Message
+    {
+        spdlog::level::level_enum level{};
+        std::string               text{};
+    };
+
+    using Messages = std::vector<Message>;
+
+private:
+    inline static thread_local Messages* capture{};
+
+public:
+    // Captures this thread's messages into messages until destroyed
+    class Capture
+    {
+        Messages* previous{};
+
+    public:
+        explicit Capture(Messages& messages) noexcept : previous(std::exchange(capture, &messages)) {}
+
+        ~Capture() noexcept { capture = previous; }
+
+        Capture(const Capture&)            = delete;
+        Capture& operator=(const Capture&) = delete;
+    };
+
+    static void Write(const Messages& messages) noexcept;
+
+    template <typename... Args>
+    static void Log(const spdlog::level::level_enum level, const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        if (!spdlog::default_logger_raw()->should_log(level)) {
+            return;
+        }
+
+        auto text{ std::format(fmt, std::forward<Args>(args)...) };
+        if (capture) {
+            capture->emplace_back(level, std::move(text));
+        }
+        else {
+            spdlog::default_logger_raw()->log(level, text);
+        }
+    }
+
+    template <typename... Args>
+    static void debug(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::debug, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    static void info(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::info, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    static void warn(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::warn, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    static void error(const std::format_string<Args...> fmt, Args&&... args) noexcept
+    {
+        Log(spdlog::level::err, fmt, std::forward<Args>(args)...);
+    }
+};
@@ -1,13 +1,37 @@
 #pragma once
 
+#include "Delimiters.h"
 #include "Map.h"
 
+struct ParsedINI
+{
+    std::vector<char>       buffer{};
+    std::vector<DistrToken> tokens{};
+};
+
 class Parser
 {
 public:
     [[nodiscard]] static DistrType ClassifyString(std::string_view s) noexcept;
 
-    [[nodiscard]] static DistrToken Tokenize(std::string s, const std::string& to_container, DistrType distr_type) noexcept;
+    [[nodiscard]] static DistrType ClassifyString(std::string_view s, const DelimiterMask& mask) noexcept;
+
+    [[nodiscard]] static DistrToken Tokenize(std::string_view s, std::string_view to_container, DistrType distr_type) noexcept;
+
+    // mask must have been scanned from s
+    [[nodiscard]] static DistrToken Tokenize(std::string_view s, std::string_view to_container, DistrType distr_type, const DelimiterMask& mask) noexcept;
+
+    [[nodiscard]] static std::vector<std::filesystem::path> FindINIs() noexcept;
+
+    [[nodiscard]] static ParsedINI ReadINI(const std::filesystem::path& path) noexcept;
+
+    [[nodiscard]] static std::vector<DistrObject> BuildRules(const std::vector<DistrToken>& tokens, u16 file) noexcept;
+
+    static void AddRules(const std::vector<DistrObject>& rules) noexcept;
 
     static void ParseINIs() noexcept;
+
+    // Main thread. Re-parses the given added, changed or removed files and patches only the distr_map entries they touch. Needs Settings::watch_inis, which keeps
+    // distr_map alive after freezing
+    static void ReloadINIs(const std::vector<std::filesystem::path>& changed) noexcept;
 };
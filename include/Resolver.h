@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Map.h"
+
+class Resolver
+{
+    struct StringHash
+    {
+        using is_transparent = void;
+        using is_avalanching = void;
+
+        [[nodiscard]] auto operator()(const std::string_view s) const noexcept { return ankerl::unordered_dense::hash<std::string_view>{}(s); }
+    };
+
+    struct PluginIndex
+    {
+        u8   compile_index{};
+        u16  small_file_compile_index{};
+        bool is_light{};
+    };
+
+    struct ResolvedForm
+    {
+        RE::TESForm* form{};
+        RE::FormID   form_id{};
+    };
+
+    inline static ankerl::unordered_dense::map<std::string, PluginIndex, StringHash, std::equal_to<>> plugin_indices{};
+
+    inline static ankerl::unordered_dense::map<std::string, ResolvedForm, StringHash, std::equal_to<>> resolved_forms{};
+
+    inline static std::shared_mutex resolved_forms_lock{};
+
+    inline static bool ready{};
+
+    inline static std::atomic<u64> hits{};
+
+    inline static std::atomic<u64> misses{};
+
+    [[nodiscard]] static FormIDAndPluginName GetFormIDAndPluginName(std::string_view identifier, std::size_t tilde_pos) noexcept;
+
+    [[nodiscard]] static RE::FormID ToLoadedFormID(const FormIDAndPluginName& form_id_and_plugin_name) noexcept;
+
+    [[nodiscard]] static ResolvedForm Resolve(std::string_view identifier) noexcept;
+
+    template <typename T>
+    [[nodiscard]] static T* LookupForm(const std::string_view identifier) noexcept
+    {
+        if (const auto form{ Resolve(identifier).form }) {
+            return form->As<T>();
+        }
+
+        return nullptr;
+    }
+
+public:
+    // Rebuilds the plugin name -> compile index table and clears the identifier cache. Must not run concurrently with the lookups below
+    static void Reset() noexcept;
+
+    // Whether Reset ran, which it does not when the rules came from the cache
+    [[nodiscard]] static bool IsReady() noexcept { return ready; }
+
+    static void LogStats() noexcept;
+
+    [[nodiscard]] static RE::TESBoundObject* GetBoundObject(std::string_view identifier) noexcept;
+
+    [[nodiscard]] static RE::FormID GetContainerFormID(std::string_view to_identifier) noexcept;
+
+    [[nodiscard]] static RE::BGSLocation* GetLocation(std::string_view identifier) noexcept;
+
+    [[nodiscard]] static RE::BGSKeyword* GetLocationKeyword(std::string_view identifier) noexcept;
+};
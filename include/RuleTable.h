@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Map.h"
+#include "Settings.h"
+
+struct FrozenRule
+{
+    RE::TESBoundObject* bound_object{};
+    RE::BGSLocation*    location{};
+    RE::BGSKeyword*     location_keyword{};
+    u16                 count{};
+    u16                 chance{};
+    u32                 index{}; // Position among the container's rules of the same type, in parse order, leveled or not
+};
+static_assert(sizeof(FrozenRule) <= 32);
+
+// Rules of one type and container that share a location or location keyword condition
+struct RuleGroup
+{
+    RE::FormID                  key{};
+    bool                        is_keyword{};
+    std::span<const FrozenRule> rules{};
+};
+
+struct TypedRules
+{
+    std::span<const FrozenRule> unconditional{};
+    std::span<const RuleGroup>  groups{};
+};
+
+// Leveled lists are split from the other add rules when freezing, and only ever distributed by add rules, so no kernel needs a type check per rule
+struct ContainerRules
+{
+    TypedRules to_add{};
+    TypedRules to_add_leveled{};
+    TypedRules to_remove{};
+    TypedRules to_remove_all{};
+};
+
+// Immutable view of Map::distr_map built once parsing is done. Every rule lives in one contiguous array, grouped per container and type as [unconditional | per location |
+// per location keyword], and containers are found through a hash-and-displace perfect hash over their FormIDs
+class RuleTable
+{
+    struct TypeRange
+    {
+        u32 unconditional_begin{};
+        u32 unconditional_end{};
+        u32 groups_begin{};
+        u32 groups_end{};
+    };
+
+    struct Entry
+    {
+        RE::FormID               form_id{};
+        std::array<TypeRange, 4> ranges{};
+    };
+
+    static constexpr u32 empty_slot{ std::numeric_limits<u32>::max() };
+
+    // One cache line of a blocked bloom filter
+    struct alignas(64) FilterBlock
+    {
+        std::array<u64, 8> words{};
+    };
+
+    inline static std::vector<FrozenRule> rules{};
+
+    inline static std::vector<RuleGroup> groups{};
+
+    inline static std::vector<Entry> entries{};
+
+    inline static std::vector<u32> slots{};
+
+    inline static std::vector<u16> pilots{};
+
+    inline static u64 slot_mask{};
+
+    inline static std::vector<FilterBlock> filter{};
+
+    // Freeze runs on the main thread, like Find and Distribute, but MayContain is also called from the background loading threads. Without hot reload the table is frozen
+    // once, before any hook can read it, so readers only take the lock when INIs are watched and keep the filter probe free of shared writes otherwise
+    inline static std::shared_mutex lock{};
+
+    [[nodiscard]] static std::shared_lock<std::shared_mutex> ReadLock() noexcept
+    {
+        return Settings::watch_inis ? std::shared_lock{ lock } : std::shared_lock<std::shared_mutex>{};
+    }
+
+    [[nodiscard]] static constexpr u64 Hash(const RE::FormID form_id, const u64 seed) noexcept
+    {
+        auto x{ (static_cast<u64>(form_id) ^ seed) + 0x9e3779b97f4a7c15 };
+        x = (x ^ x >> 30) * 0xbf58476d1ce4e5b9;
+        x = (x ^ x >> 27) * 0x94d049bb133111eb;
+
+        return x ^ x >> 31;
+    }
+
+    [[nodiscard]] static constexpr u64 PilotSeed(const u16 pilot) noexcept { return (static_cast<u64>(pilot) + 1) * 0x2545f4914f6cdd1d; }
+
+    [[nodiscard]] static bool BuildPerfectHash(u64 slot_count) noexcept;
+
+    static void BuildFilter() noexcept;
+
+    // Perfect hash and filter over entries
+    static void BuildIndex() noexcept;
+
+    // FormIDs of the forms named by rules from first_rule on
+    static void AppendRuleForms(std::size_t first_rule, std::vector<RE::FormID>& out) noexcept;
+
+    static void LogMeasurements() noexcept;
+
+    // Appends the rules of vec whose bound object is (leveled) or is not (!leveled) a leveled list
+    [[nodiscard]] static TypeRange AppendRules(const TDistrVec& vec, bool leveled) noexcept;
+
+    // Index into entries, or empty_slot
+    [[nodiscard]] static u32 EntryIndex(const RE::FormID form_id) noexcept
+    {
+        if (entries.empty()) {
+            return empty_slot;
+        }
+
+        const auto bucket{ Hash(form_id, 0) % pilots.size() };
+        const auto slot{ slots[Hash(form_id, PilotSeed(pilots[bucket])) & slot_mask] };
+
+        return slot != empty_slot && entries[slot].form_id == form_id ? slot : empty_slot;
+    }
+
+    [[nodiscard]] static TypedRules ToTypedRules(const TypeRange& range) noexcept
+    {
+        return { .unconditional = std::span{ rules }.subspan(range.unconditional_begin, range.unconditional_end - range.unconditional_begin),
+                 .groups        = std::span{ groups }.subspan(range.groups_begin, range.groups_end - range.groups_begin) };
+    }
+
+public:
+    static void Freeze() noexcept;
+
+    // Main thread, after hot reload changed the distr_map entries of form_ids. Only their rules are rebuilt, after the others, so the spans of the rest stay valid; the
+    // perfect hash and filter are only rebuilt when containers gained or lost all their rules. Freezes everything again once the room Freeze left for this runs out
+    static void Patch(std::span<const RE::FormID> form_ids) noexcept;
+
+    // False means no container with this FormID has rules. Probes a single cache line, using the upper hash bits for the block and four 9-bit slices for the bits in it
+    [[nodiscard]] static bool MayContain(const RE::FormID form_id) noexcept
+    {
+        const auto l{ ReadLock() };
+        if (filter.empty()) {
+            return false;
+        }
+
+        const auto  hash{ Hash(form_id, 0) };
+        const auto& [words]{ filter[(hash >> 36) % filter.size()] };
+        for (auto i{ 0 }; i < 4; ++i) {
+            const auto bit{ hash >> (i * 9) & 511 };
+            if (!(words[bit >> 6] & 1ULL << (bit & 63))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // The spans returned stay valid until the next Freeze or Patch, which only run on the main thread
+    [[nodiscard]] static std::optional<ContainerRules> Find(const RE::FormID form_id) noexcept
+    {
+        const auto l{ ReadLock() };
+        const auto index{ EntryIndex(form_id) };
+        if (index == empty_slot) {
+            return std::nullopt;
+        }
+
+        const auto& ranges{ entries[index].ranges };
+
+        return ContainerRules{ .to_add         = ToTypedRules(ranges[0]),
+                               .to_add_leveled = ToTypedRules(ranges[1]),
+                               .to_remove      = ToTypedRules(ranges[2]),
+                               .to_remove_all  = ToTypedRules(ranges[3]) };
+    }
+
+    [[nodiscard]] static auto Size() noexcept
+    {
+        const auto l{ ReadLock() };
+        return entries.size();
+    }
+
+    [[nodiscard]] static std::vector<RE::FormID> FormIDs() noexcept
+    {
+        const auto              l{ ReadLock() };
+        std::vector<RE::FormID> form_ids;
+        form_ids.reserve(entries.size());
+        for (const auto& entry : entries) {
+            form_ids.emplace_back(entry.form_id);
+        }
+
+        return form_ids;
+    }
+
+    [[nodiscard]] static std::size_t MemoryUsage() noexcept
+    {
+        const auto l{ ReadLock() };
+        return rules.capacity() * sizeof(FrozenRule) + groups.capacity() * sizeof(RuleGroup) + entries.capacity() * sizeof(Entry) + slots.capacity() * sizeof(u32) +
+               pilots.capacity() * sizeof(u16) + filter.capacity() * sizeof(FilterBlock);
+    }
+};
+
+template <>
+struct std::formatter<FrozenRule> : std::formatter<std::string_view>
+{
+    template <typename FmtContext>
+    auto format(const FrozenRule& rule, FmtContext& ctx) const
+    {
+        const auto& [bound_object, location, location_keyword, count, chance, index]{ rule };
+        const auto formatted{ std::format("[Bound object: {} ({:#x}) / Count: {} / Location: {} ({:#x}) / Location keyword: {} ({:#x}) / Chance: {}]", GetFormEditorID(bound_object),
+                                          bound_object ? bound_object->GetFormID() : 0x0U, count, GetFormEditorID(location), location ? location->GetFormID() : 0x0U,
+                                          GetFormEditorID(location_keyword), location_keyword ? location_keyword->GetFormID() : 0x0U, chance) };
+
+        return formatter<std::string_view>::format(formatted, ctx);
+    }
+};
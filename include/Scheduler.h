@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ankerl/unordered_dense.h"
+
+// Containers found while loading 3D are queued here and distributed on the main thread, a few per frame within Settings::frame_budget_ms
+class Scheduler
+{
+    struct Entry
+    {
+        RE::FormID form_id{};
+        u32        frames_waited{}; // Frames spent waiting for 3D
+    };
+
+    inline static std::mutex lock{};
+
+    inline static std::deque<Entry> queue{};
+
+    inline static ankerl::unordered_dense::set<RE::FormID> queued{};
+
+    [[nodiscard]] static std::optional<Entry> Pop() noexcept;
+
+    static void Push(Entry entry) noexcept;
+
+public:
+    // Background loading delivers 3D within a few frames. A ref still without it after this long was unloaded first, and Load3D queues it again if it comes back
+    static constexpr u32 max_frames_waited{ 300 };
+
+    static void Enqueue(const RE::TESObjectREFR* ref) noexcept;
+
+    // Main thread, once per frame. Refs whose 3D is still loading in the background stay queued for up to max_frames_waited frames, refs that are gone are dropped
+    static void RunFrame() noexcept;
+
+    // Main thread. Distributes ref right away if it is still waiting in the queue. Called when a container or NPC is activated or comes under the crosshair, which
+    // covers opening, looting and loot menu previews. Inventories read by scripts, like OpenInventory, can still see a ref before it was distributed
+    static void Flush(RE::TESObjectREFR* ref) noexcept;
+
+    // Main thread, after the engine reset ref's inventory. A full reset drops what was distributed, so its tracking goes too, and respawning containers are distributed
+    // again. A leveled-only reset keeps the distributed objects, and with them their tracking
+    static void OnResetInventory(RE::TESObjectREFR* ref, bool leveled_only) noexcept;
+
+    // Main thread, when a save is loaded. The queued FormIDs belong to the previous game
+    static void Clear() noexcept;
+
+    [[nodiscard]] static std::size_t QueueDepth() noexcept;
+};
@@ -6,4 +6,20 @@ public:
     static void LoadSettings() noexcept;
 
     inline static bool debug_logging{};
+
+    inline static bool use_cache{ true };
+
+    inline static bool deterministic_chance{};
+
+    inline static u64 chance_seed{};
+
+    inline static double frame_budget_ms{ 1.0 };
+
+    inline static bool watch_inis{};
+
+    inline static u32 watch_interval_ms{ 1000 };
+
+    inline static bool stats_enabled{};
+
+    inline static u32 stats_interval_s{ 60 };
 };
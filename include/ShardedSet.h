@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ankerl/unordered_dense.h"
+
+// Set of FormIDs split into independently locked shards, safe to use from the background loading threads and the main thread at the same time
+template <typename K, std::size_t Shards = 16>
+class ShardedSet
+{
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex       lock{};
+        ankerl::unordered_dense::set<K> set{};
+    };
+
+    std::array<Shard, Shards> shards{};
+
+    [[nodiscard]] Shard& GetShard(const K& key) noexcept { return shards[ankerl::unordered_dense::hash<K>{}(key) % Shards]; }
+
+    [[nodiscard]] const Shard& GetShard(const K& key) const noexcept { return shards[ankerl::unordered_dense::hash<K>{}(key) % Shards]; }
+
+public:
+    [[nodiscard]] bool Contains(const K& key) const noexcept
+    {
+        const auto&      shard{ GetShard(key) };
+        std::shared_lock l{ shard.lock };
+
+        return shard.set.contains(key);
+    }
+
+    // Atomic claim: true for exactly one of any number of concurrent callers with the same key
+    bool Insert(const K& key) noexcept
+    {
+        auto& [lock, set]{ GetShard(key) };
+        std::unique_lock l{ lock };
+
+        return set.insert(key).second;
+    }
+
+    bool Erase(const K& key) noexcept
+    {
+        auto& [lock, set]{ GetShard(key) };
+        std::unique_lock l{ lock };
+
+        return set.erase(key) > 0;
+    }
+
+    void Clear() noexcept
+    {
+        for (auto& [lock, set] : shards) {
+            std::unique_lock l{ lock };
+            set.clear();
+        }
+    }
+
+    [[nodiscard]] std::size_t Size() const noexcept
+    {
+        std::size_t size{};
+        for (const auto& shard : shards) {
+            std::shared_lock l{ shard.lock };
+            size += shard.set.size();
+        }
+
+        return size;
+    }
+
+    [[nodiscard]] std::size_t MemoryUsage() const noexcept
+    {
+        std::size_t bytes{ sizeof(shards) };
+        for (const auto& shard : shards) {
+            std::shared_lock l{ shard.lock };
+            bytes += shard.set.bucket_count() * sizeof(u64) + shard.set.values().capacity() * sizeof(K);
+        }
+
+        return bytes;
+    }
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Settings.h"
+
+enum struct Probe : u8
+{
+    Load3D,
+    Load3DCharacter,
+    ResetInventory,
+    SaveGame,
+    Distribute,
+    SchedulerFrame,
+    ParseDirectoryScan,
+    ParseINILoad,
+    ParseTokenize,
+    ParseResolve,
+    Count
+};
+
+// Call counts and log2 latency histograms, always compiled in and switched on by [Stats] Enabled. A summary is written as JSON to the SKSE log directory every
+// Settings::stats_interval_s seconds
+class Stats
+{
+    inline static std::chrono::steady_clock::time_point start_time{};
+
+    [[nodiscard]] static std::filesystem::path GetPath() noexcept;
+
+    static void Run() noexcept;
+
+    static void WriteSummary() noexcept;
+
+public:
+    static void Start() noexcept;
+
+    static void Record(Probe probe, u64 ns) noexcept;
+
+    // Times its scope into probe. Does nothing but one branch when stats are disabled
+    class Timer
+    {
+        using clock = std::chrono::steady_clock;
+
+        Probe             probe;
+        clock::time_point start{};
+        clock::duration   excluded{};
+
+    public:
+        explicit Timer(const Probe a_probe) noexcept : probe(a_probe)
+        {
+            if (Settings::stats_enabled) {
+                start = clock::now();
+            }
+        }
+
+        ~Timer() noexcept
+        {
+            if (Settings::stats_enabled) {
+                Record(probe, static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start - excluded).count()));
+            }
+        }
+
+        Timer(const Timer&)            = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        // Runs f without counting its time, so hooks measure only their own work and not the engine function they wrap
+        template <typename F>
+        decltype(auto) Exclude(F&& f) noexcept
+        {
+            if (!Settings::stats_enabled) {
+                return f();
+            }
+
+            const auto before{ clock::now() };
+            struct Resume
+            {
+                Timer&            timer;
+                clock::time_point before;
+
+                ~Resume() { timer.excluded += clock::now() - before; }
+            } resume{ *this, before };
+
+            return f();
+        }
+    };
+};
@@ -1,195 +1,82 @@
 #pragma once
 
+#include "Game.h"
 #include "Map.h"
+#include "ParseLog.h"
+#include "Resolver.h"
+#include "Settings.h"
 
 class Utility
 {
-    [[nodiscard]] static auto IsEditorID(const std::string_view identifier) noexcept { return !identifier.contains('~'); }
-
-    [[nodiscard]] static FormIDAndPluginName GetFormIDAndPluginName(const std::string& identifier) noexcept
+public:
+    // The returned span points into a per-thread buffer that is reused by the next call on the same thread
+    [[nodiscard]] static std::span<const ObjectAndCount> ResolveLeveledList(RE::TESLevItem* leveled_list, const u32 count) noexcept
     {
-        if (const auto tilde_pos{ identifier.find('~') }; tilde_pos != std::string_view::npos) {
-            const auto form_id{ Map::ToFormID(identifier.substr(0, tilde_pos)) };
-            const auto plugin_name{ identifier.substr(tilde_pos + 1) };
-            return { .form_id = form_id, .plugin_name = plugin_name };
-        }
-        logger::error("\t\tERROR: Failed to get FormID and plugin name for {}", identifier);
+        thread_local std::vector<ObjectAndCount> calced_objects;
+        thread_local std::vector<ObjectAndCount> result;
+        calced_objects.clear();
+        result.clear();
 
-        return { .form_id = 0x0, .plugin_name = "" };
-    }
+        Game::CalculateLeveledList(leveled_list, count, calced_objects);
 
-    [[nodiscard]] static RE::TESBoundObject* GetBoundObject(const std::string& identifier) noexcept
-    {
-        if (IsEditorID(identifier)) {
-            if (const auto bound_obj{ RE::TESForm::LookupByEditorID<RE::TESBoundObject>(identifier) }) {
-                return bound_obj;
+        for (const auto& [bound_obj, c] : calced_objects) {
+            // The same object can come out of several entries or nested lists, so counts add up
+            if (const auto it{ std::ranges::find(result, bound_obj, &ObjectAndCount::obj) }; it != result.end()) {
+                it->count += c;
             }
-        }
-        else {
-            const auto handler{ RE::TESDataHandler::GetSingleton() };
-            const auto [form_id, plugin_name]{ GetFormIDAndPluginName(identifier) };
-            if (const auto form{ handler->LookupForm(form_id, plugin_name) }) {
-                if (const auto bound_obj{ form->As<RE::TESBoundObject>() }) {
-                    return bound_obj;
-                }
+            else {
+                result.emplace_back(bound_obj, c);
             }
         }
-        logger::warn("\t\tWARNING: Failed to find bound object for {}", identifier);
 
-        return nullptr;
-    }
-
-    [[nodiscard]] static RE::FormID GetContainerFormID(const std::string& to_identifier) noexcept
-    {
-        if (IsEditorID(to_identifier)) {
-            if (const auto form{ RE::TESForm::LookupByEditorID(to_identifier) }) {
-                return form->GetFormID();
-            }
-        }
-        else {
-            const auto [form_id, plugin_name]{ GetFormIDAndPluginName(to_identifier) };
-            const auto handler{ RE::TESDataHandler::GetSingleton() };
-
-            return handler->LookupFormID(form_id, plugin_name);
-        }
-
-        return 0x0U;
+        return result;
     }
 
-    [[nodiscard]] static RE::BGSLocation* GetLocation(const std::string& identifier) noexcept
+    [[nodiscard]] static constexpr u64 Mix(u64 x) noexcept
     {
-        if (identifier.empty()) {
-            return nullptr;
-        }
-
-        if (IsEditorID(identifier)) {
-            if (const auto location{ RE::TESForm::LookupByEditorID<RE::BGSLocation>(identifier) }) {
-                return location;
-            }
-        }
-        else {
-            const auto handler{ RE::TESDataHandler::GetSingleton() };
-            const auto [form_id, plugin_name]{ GetFormIDAndPluginName(identifier) };
-            if (const auto form{ handler->LookupForm(form_id, plugin_name) }) {
-                if (const auto location{ form->As<RE::BGSLocation>() }) {
-                    return location;
-                }
-            }
-        }
-        logger::warn("\t\tWARNING: Failed to find location for {}", identifier);
+        x = (x ^ x >> 30) * 0xbf58476d1ce4e5b9;
+        x = (x ^ x >> 27) * 0x94d049bb133111eb;
 
-        return nullptr;
+        return x ^ x >> 31;
     }
 
-    [[nodiscard]] static RE::BGSKeyword* GetLocationKeyword(const std::string& identifier) noexcept
+    // splitmix64 with one state per thread
+    [[nodiscard]] static u64 NextRandom() noexcept
     {
-        if (identifier.empty()) {
-            return nullptr;
-        }
+        thread_local u64 state{ static_cast<u64>(std::random_device{}()) << 32 ^ std::random_device{}() };
 
-        if (IsEditorID(identifier)) {
-            if (const auto location_keyword{ RE::TESForm::LookupByEditorID<RE::BGSKeyword>(identifier) }) {
-                return location_keyword;
-            }
-        }
-        else {
-            const auto handler{ RE::TESDataHandler::GetSingleton() };
-            const auto [form_id, plugin_name]{ GetFormIDAndPluginName(identifier) };
-            if (const auto form{ handler->LookupForm(form_id, plugin_name) }) {
-                if (const auto location_keyword{ form->As<RE::BGSKeyword>() }) {
-                    return location_keyword;
-                }
-            }
-        }
-        logger::warn("\t\tWARNING: Failed to find location keyword for {}", identifier);
+        state += 0x9e3779b97f4a7c15;
 
-        return nullptr;
+        return Mix(state);
     }
 
-    [[nodiscard]] static auto ResolveLeveledList(RE::TESLevItem* leveled_list, const u32 count) noexcept
+    // Rolls 1-100 against chance. Rules at 100% never roll. In deterministic mode the roll only depends on the container, the rule and the configured seed
+    [[nodiscard]] static bool RollChance(const u16 chance, const RE::FormID container_form_id, const DistrType type, const u64 rule_index) noexcept
     {
-        RE::BSScrapArray<RE::CALCED_OBJECT>                    calced_objects;
-        ankerl::unordered_dense::map<RE::TESBoundObject*, u32> result;
-
-        if (const auto player{ RE::PlayerCharacter::GetSingleton() }) {
-            leveled_list->CalculateCurrentFormList(player->GetLevel(), static_cast<i16>(count), calced_objects, 0, true);
-        }
-        else {
-            logger::error("\t\tERROR: Failed to find player level for resolving leveled list {} ({:#x})", GetFormEditorID(leveled_list), leveled_list->GetFormID());
+        if (chance >= 100) {
+            return true;
         }
 
-        for (const auto& c : calced_objects) {
-            if (const auto bound_obj{ c.form->As<RE::TESBoundObject>() }) {
-                result[bound_obj] = c.count;
-            }
-        }
+        const auto random{ Settings::deterministic_chance ?
+                               Mix(Mix(Settings::chance_seed ^ container_form_id) + (static_cast<u64>(type) << 32 | rule_index)) :
+                               NextRandom() };
 
-        return result;
-    }
-
-public:
-    [[nodiscard]] static auto GetRandomChance() noexcept
-    {
-        static std::random_device                 rd;
-        static std::mt19937                       rng(rd());
-        static std::uniform_int_distribution<u16> distr(1, 100);
-
-        return distr(rng);
-    }
-
-    static auto AddObjectsFromResolvedList(RE::TESObjectREFR* ref, RE::TESLevItem* leveled_list, const u32 count) noexcept
-    {
-        logger::info("Adding {} {} to ref {}", count, leveled_list, ref);
-
-        for (const auto& [bound_obj, c] : ResolveLeveledList(leveled_list, count)) {
-            ref->AddObjectToContainer(bound_obj, nullptr, c, nullptr);
-            Map::added_objects[ref].emplace_back(bound_obj, c);
-            logger::info("\t+ {} {}", c, bound_obj);
-        }
-
-        logger::info("");
+        return ((random >> 32) * 100 >> 32) + 1 <= chance;
     }
 
     [[nodiscard]] static DistrObject BuildDistrObject(const DistrToken& distr_token) noexcept
     {
-        if (const auto bound_obj{ GetBoundObject(distr_token.identifier) }) {
+        if (const auto bound_obj{ Resolver::GetBoundObject(distr_token.identifier) }) {
             return { .type              = distr_token.type,
-                     .container_form_id = GetContainerFormID(distr_token.to_identifier),
+                     .container_form_id = Resolver::GetContainerFormID(distr_token.to_identifier),
                      .bound_object      = bound_obj,
                      .count             = distr_token.count,
-                     .location          = GetLocation(distr_token.location),
-                     .location_keyword  = GetLocationKeyword(distr_token.location_keyword),
+                     .location          = Resolver::GetLocation(distr_token.location),
+                     .location_keyword  = Resolver::GetLocationKeyword(distr_token.location_keyword),
                      .chance            = distr_token.chance };
         }
-        logger::error("\t\tERROR: Failed to build DistrObject for {}", distr_token);
+        ParseLog::error("\t\tERROR: Failed to build DistrObject for {}", distr_token);
 
         return { .type = DistrType::Error, .container_form_id = 0x0U, .bound_object = nullptr, .count = 0U, .location = nullptr, .location_keyword = nullptr, .chance = 0U };
     }
-
-    [[nodiscard]] static auto ShouldSkip(RE::TESObjectREFR* ref, const RE::BGSLocation* location, const RE::BGSKeyword* location_keyword) noexcept
-    {
-        if (const auto ref_location{ ref->GetCurrentLocation() }) {
-            if (location) {
-                if (ref_location->GetFormID() == location->GetFormID()) {
-                    logger::debug("! Skipping {}, location {} does not match {} ({:#x})", ref, GetFormEditorID(ref->GetCurrentLocation()), GetFormEditorID(location),
-                                  location->GetFormID());
-                    logger::debug("");
-                    return true;
-                }
-            }
-            if (location_keyword) {
-                if (!ref_location->HasKeyword(location_keyword)) {
-                    logger::debug("! Skipping {}, location {} does not have keyword {} ({:#x})", ref, GetFormEditorID(ref->GetCurrentLocation()), GetFormEditorID(location_keyword),
-                                  location_keyword->GetFormID());
-                    logger::debug("");
-                    return true;
-                }
-            }
-        }
-        else {
-            logger::error("ERROR: Failed to get current location for {} ({:#x})", GetFormEditorID(ref), ref->GetFormID());
-        }
-
-        return false;
-    }
 };
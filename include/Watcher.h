@@ -0,0 +1,31 @@
+#pragma once
+
+// Polls Data for added, changed or removed _CID.ini files and hands them to Parser::ReloadINIs on the main thread. Enabled by [Watch] Enabled
+class Watcher
+{
+    struct FileState
+    {
+        std::filesystem::file_time_type write_time{};
+        std::uintmax_t                  size{};
+
+        bool operator==(const FileState&) const = default;
+    };
+
+    using Snapshot = std::map<std::filesystem::path, FileState>;
+
+    inline static Snapshot snapshot{};
+
+    inline static std::mutex lock{};
+
+    inline static std::vector<std::filesystem::path> pending{};
+
+    [[nodiscard]] static Snapshot TakeSnapshot() noexcept;
+
+    static void Run() noexcept;
+
+    // Main thread
+    static void Apply() noexcept;
+
+public:
+    static void Start() noexcept;
+};
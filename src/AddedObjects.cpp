@@ -0,0 +1,139 @@
+#include "AddedObjects.h"
+
+u32 AddedObjects::Shard::AllocateNode(const Record& record) noexcept
+{
+    if (free_head != npos) {
+        const auto n{ free_head };
+        free_head = slab[n].next;
+        --free_nodes;
+        slab[n] = { .record = record, .next = npos };
+        return n;
+    }
+
+    slab.emplace_back(record, npos);
+
+    return static_cast<u32>(slab.size() - 1);
+}
+
+void AddedObjects::CopyRecords(const RE::FormID ref, std::vector<Record>& out) const noexcept
+{
+    out.clear();
+
+    const auto&     shard{ GetShard(ref) };
+    std::scoped_lock l{ shard.lock };
+
+    const auto it{ shard.entries.find(ref) };
+    if (it == shard.entries.end()) {
+        return;
+    }
+
+    const auto& [records, size, overflow]{ it->second };
+    out.insert(out.end(), records.begin(), records.begin() + std::min(size, inline_capacity));
+    for (auto n{ overflow }; n != npos; n = shard.slab[n].next) {
+        out.emplace_back(shard.slab[n].record);
+    }
+}
+
+void AddedObjects::Add(const RE::FormID ref, const RE::FormID obj, const u32 count) noexcept
+{
+    auto&            shard{ GetShard(ref) };
+    std::scoped_lock l{ shard.lock };
+
+    auto& [records, size, overflow]{ shard.entries[ref] };
+
+    for (u32 i{}; i < std::min(size, inline_capacity); ++i) {
+        if (records[i].obj == obj) {
+            records[i].count += count;
+            return;
+        }
+    }
+    for (auto n{ overflow }; n != npos; n = shard.slab[n].next) {
+        if (shard.slab[n].record.obj == obj) {
+            shard.slab[n].record.count += count;
+            return;
+        }
+    }
+
+    if (size < inline_capacity) {
+        records[size] = { .obj = obj, .count = count };
+    }
+    else {
+        const auto n{ shard.AllocateNode({ .obj = obj, .count = count }) };
+        shard.slab[n].next = overflow;
+        overflow           = n;
+    }
+    ++size;
+}
+
+bool AddedObjects::Contains(const RE::FormID ref) const noexcept
+{
+    const auto&      shard{ GetShard(ref) };
+    std::scoped_lock l{ shard.lock };
+
+    return shard.entries.contains(ref);
+}
+
+void AddedObjects::Erase(const RE::FormID ref) noexcept
+{
+    auto&            shard{ GetShard(ref) };
+    std::scoped_lock l{ shard.lock };
+
+    const auto it{ shard.entries.find(ref) };
+    if (it == shard.entries.end()) {
+        return;
+    }
+
+    for (auto n{ it->second.overflow }; n != npos;) {
+        const auto next{ shard.slab[n].next };
+        shard.slab[n].next = shard.free_head;
+        shard.free_head    = n;
+        ++shard.free_nodes;
+        n = next;
+    }
+
+    shard.entries.erase(it);
+}
+
+void AddedObjects::Clear() noexcept
+{
+    for (auto& shard : shards) {
+        std::scoped_lock l{ shard.lock };
+        shard.entries.clear();
+        shard.slab.clear();
+        shard.free_head  = npos;
+        shard.free_nodes = 0;
+    }
+}
+
+std::size_t AddedObjects::Size() const noexcept
+{
+    std::size_t size{};
+    for (const auto& shard : shards) {
+        std::scoped_lock l{ shard.lock };
+        size += shard.entries.size();
+    }
+
+    return size;
+}
+
+u32 AddedObjects::FreeNodes() const noexcept
+{
+    u32 free_nodes{};
+    for (const auto& shard : shards) {
+        std::scoped_lock l{ shard.lock };
+        free_nodes += shard.free_nodes;
+    }
+
+    return free_nodes;
+}
+
+std::size_t AddedObjects::MemoryUsage() const noexcept
+{
+    std::size_t bytes{ sizeof(shards) };
+    for (const auto& shard : shards) {
+        std::scoped_lock l{ shard.lock };
+        bytes += shard.entries.bucket_count() * sizeof(u64) + shard.entries.values().capacity() * sizeof(std::pair<RE::FormID, Entry>) + shard.slab.capacity() * sizeof(Node);
+    }
+
+    return bytes;
+}
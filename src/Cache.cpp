@@ -0,0 +1,166 @@
+#include "Cache.h"
+
+#include "Game.h"
+#include "Lexer.h"
+
+namespace
+{
+    constexpr u64 fnv_offset_basis{ 0xcbf29ce484222325 };
+    constexpr u64 fnv_prime{ 0x100000001b3 };
+
+    [[nodiscard]] u64 HashBytes(const std::span<const char> bytes, u64 hash = fnv_offset_basis) noexcept
+    {
+        for (const auto b : bytes) {
+            hash ^= static_cast<u8>(b);
+            hash *= fnv_prime;
+        }
+
+        return hash;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] u64 HashValue(const T& value, const u64 hash) noexcept
+    {
+        return HashBytes({ reinterpret_cast<const char*>(std::addressof(value)), sizeof(T) }, hash);
+    }
+} // namespace
+
+std::filesystem::path Cache::GetPath() noexcept
+{
+    if (const auto log_dir{ Game::GetLogDirectory() }) {
+        return *log_dir / std::format("{}.cache", Game::GetPluginName());
+    }
+
+    return {};
+}
+
+u64 Cache::Fingerprint(const std::vector<std::filesystem::path>& cid_inis) noexcept
+{
+    auto hash{ HashValue(version, fnv_offset_basis) };
+
+    // A plugin updated under the same name and slot can move an editor ID to another form, so its size and write time count too
+    const auto data_dir{ Game::GetDataDirectory() };
+    for (const auto& [name, compile_index, small_file_compile_index, is_light] : Game::GetPlugins()) {
+        hash = HashBytes(name, hash);
+        hash = HashValue(compile_index, hash);
+        hash = HashValue(small_file_compile_index, hash);
+
+        const auto      path{ data_dir / name };
+        std::error_code ec{};
+        const auto      size{ std::filesystem::file_size(path, ec) };
+        hash = HashValue(ec ? 0x0ULL : static_cast<u64>(size), hash);
+        const auto write_time{ std::filesystem::last_write_time(path, ec) };
+        hash = HashValue(ec ? 0x0LL : static_cast<i64>(write_time.time_since_epoch().count()), hash);
+    }
+
+    std::vector<char> buffer;
+    for (const auto& f : cid_inis) {
+        const auto filename{ f.filename().string() };
+        hash = HashBytes(filename, hash);
+        hash = Lexer::LoadFile(f, buffer) ? HashBytes(buffer, hash) : HashValue(0x0ULL, hash);
+    }
+
+    return hash;
+}
+
+std::optional<std::vector<DistrObject>> Cache::Load(const u64 fingerprint) noexcept
+{
+    const auto path{ GetPath() };
+    if (path.empty() || !exists(path)) {
+        return std::nullopt;
+    }
+
+    std::ifstream file{ path, std::ios::binary };
+
+    Header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(Header)) || header.magic != magic || header.version != version) {
+        logger::info("Rule cache is invalid, reparsing");
+        return std::nullopt;
+    }
+
+    if (header.fingerprint != fingerprint) {
+        logger::info("Rule cache is out of date ({:#x} != {:#x}), reparsing", header.fingerprint, fingerprint);
+        return std::nullopt;
+    }
+
+    // The count comes from disk, so it is checked against the file before anything is allocated for it
+    std::error_code ec{};
+    const auto      file_size{ std::filesystem::file_size(path, ec) };
+    if (ec || file_size < sizeof(Header) || header.rule_count > (file_size - sizeof(Header)) / sizeof(Record)) {
+        logger::info("Rule cache is truncated, reparsing");
+        return std::nullopt;
+    }
+
+    std::vector<Record> records(header.rule_count);
+    if (!file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)))) {
+        logger::info("Rule cache is truncated, reparsing");
+        return std::nullopt;
+    }
+
+    std::vector<DistrObject> rules;
+    rules.reserve(records.size());
+
+    for (const auto& r : records) {
+        const auto bound_object{ Game::LookupByID<RE::TESBoundObject>(r.bound_object) };
+        const auto location{ r.location ? Game::LookupByID<RE::BGSLocation>(r.location) : nullptr };
+        const auto location_keyword{ r.location_keyword ? Game::LookupByID<RE::BGSKeyword>(r.location_keyword) : nullptr };
+
+        if (!bound_object || (r.location && !location) || (r.location_keyword && !location_keyword)) {
+            logger::info("Rule cache references missing form {:#x}, reparsing", r.bound_object);
+            return std::nullopt;
+        }
+
+        rules.emplace_back(r.type, r.container_form_id, bound_object, r.count, location, location_keyword, r.chance, r.file);
+    }
+
+    logger::info("Loaded {} rules from {}", rules.size(), path.filename().string());
+
+    return rules;
+}
+
+void Cache::Save(const u64 fingerprint, const std::vector<std::vector<DistrObject>>& rules_per_file) noexcept
+{
+    const auto path{ GetPath() };
+    if (path.empty()) {
+        return;
+    }
+
+    std::vector<Record> records;
+    for (const auto& rules : rules_per_file) {
+        for (const auto& [type, container_form_id, bound_object, count, location, location_keyword, chance, file] : rules) {
+            records.emplace_back(Record{ .container_form_id = container_form_id,
+                                         .bound_object      = bound_object->GetFormID(),
+                                         .location          = location ? location->GetFormID() : 0x0U,
+                                         .location_keyword  = location_keyword ? location_keyword->GetFormID() : 0x0U,
+                                         .count             = count,
+                                         .chance            = chance,
+                                         .type              = type,
+                                         .file              = file });
+        }
+    }
+
+    const Header header{ .magic = magic, .version = version, .fingerprint = fingerprint, .rule_count = records.size() };
+
+    auto tmp_path{ path };
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream file{ tmp_path, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        if (!file) {
+            logger::error("ERROR: Failed to write rule cache {}", tmp_path.filename().string());
+            return;
+        }
+    }
+
+    std::error_code ec{};
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        logger::error("ERROR: Failed to replace rule cache {} ({})", path.filename().string(), ec.message());
+        return;
+    }
+
+    logger::info("Wrote {} rules to {}", records.size(), path.filename().string());
+}
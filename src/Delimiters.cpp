@@ -0,0 +1,131 @@
+#include "Delimiters.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#    include <immintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define CID_TARGET_AVX2
+#    else
+#        define CID_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#    define CID_SIMD
+#endif
+
+namespace
+{
+    constexpr std::array delimiter_chars{ '|', '?', '@' };
+
+#ifdef CID_SIMD
+    [[nodiscard]] bool HasAVX2() noexcept
+    {
+#    if defined(_MSC_VER)
+        std::array<int, 4> regs{};
+        __cpuid(regs.data(), 0);
+        if (regs[0] < 7) {
+            return false;
+        }
+
+        // AVX2 also needs the OS to save the upper YMM halves
+        __cpuid(regs.data(), 1);
+        if (!(regs[2] & 1 << 27) || !(regs[2] & 1 << 28) || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+
+        __cpuidex(regs.data(), 7, 0);
+        return regs[1] & 1 << 5;
+#    else
+        return __builtin_cpu_supports("avx2");
+#    endif
+    }
+
+    // Both kernels fill whole 64-bit words and return how many bytes they covered
+
+    std::size_t ScanSSE2(const std::string_view s, std::array<u64*, 3> words) noexcept
+    {
+        const auto bar{ _mm_set1_epi8('|') };
+        const auto question{ _mm_set1_epi8('?') };
+        const auto at{ _mm_set1_epi8('@') };
+
+        std::size_t i{};
+        for (; i + 64 <= s.size(); i += 64) {
+            std::array<u64, 3> bits{};
+            for (std::size_t j{}; j < 64; j += 16) {
+                const auto chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.data() + i + j)) };
+                bits[0] |= static_cast<u64>(static_cast<u16>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, bar)))) << j;
+                bits[1] |= static_cast<u64>(static_cast<u16>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, question)))) << j;
+                bits[2] |= static_cast<u64>(static_cast<u16>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, at)))) << j;
+            }
+            for (std::size_t d{}; d < words.size(); ++d) {
+                words[d][i / 64] = bits[d];
+            }
+        }
+
+        return i;
+    }
+
+    CID_TARGET_AVX2 std::size_t ScanAVX2(const std::string_view s, std::array<u64*, 3> words) noexcept
+    {
+        const auto bar{ _mm256_set1_epi8('|') };
+        const auto question{ _mm256_set1_epi8('?') };
+        const auto at{ _mm256_set1_epi8('@') };
+
+        std::size_t i{};
+        for (; i + 64 <= s.size(); i += 64) {
+            std::array<u64, 3> bits{};
+            for (std::size_t j{}; j < 64; j += 32) {
+                const auto chunk{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.data() + i + j)) };
+                bits[0] |= static_cast<u64>(static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, bar)))) << j;
+                bits[1] |= static_cast<u64>(static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, question)))) << j;
+                bits[2] |= static_cast<u64>(static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, at)))) << j;
+            }
+            for (std::size_t d{}; d < words.size(); ++d) {
+                words[d][i / 64] = bits[d];
+            }
+        }
+
+        return i;
+    }
+
+    const auto scan_kernel{ HasAVX2() ? ScanAVX2 : ScanSSE2 };
+#endif
+}
+
+void DelimiterMask::ScanScalar(const std::string_view s) noexcept
+{
+    size = s.size();
+    for (auto& mask : masks) {
+        mask.assign((s.size() + 63) / 64, 0);
+    }
+
+    for (std::size_t i{}; i < s.size(); ++i) {
+        for (std::size_t d{}; d < delimiter_chars.size(); ++d) {
+            masks[d][i / 64] |= static_cast<u64>(s[i] == delimiter_chars[d]) << (i % 64);
+        }
+    }
+}
+
+void DelimiterMask::Scan(const std::string_view s) noexcept
+{
+#ifdef CID_SIMD
+    size = s.size();
+
+    const auto word_count{ (s.size() + 63) / 64 };
+    for (auto& mask : masks) {
+        mask.resize(word_count);
+    }
+
+    const auto done{ scan_kernel(s, { masks[0].data(), masks[1].data(), masks[2].data() }) };
+    if (done == s.size()) {
+        return;
+    }
+
+    // Most values are shorter than a word, so the tail also goes through the kernel, zero padded
+    std::array<char, 64> tail{};
+    std::memcpy(tail.data(), s.data() + done, s.size() - done);
+
+    const auto w{ done / 64 };
+    scan_kernel({ tail.data(), tail.size() }, { masks[0].data() + w, masks[1].data() + w, masks[2].data() + w });
+#else
+    ScanScalar(s);
+#endif
+}
@@ -0,0 +1,86 @@
+#include "DistrLog.h"
+
+#include "RuleTable.h"
+
+namespace
+{
+    [[nodiscard]] std::string FormatForm(const RE::FormID form_id) noexcept
+    {
+        if (const auto editor_id{ EditorIDs::Find(form_id) }) {
+            return std::format("[{}] ({:#x})", *editor_id, form_id);
+        }
+
+        return std::format("{:#x}", form_id);
+    }
+} // namespace
+
+void DistrLog::Start() noexcept
+{
+    // Detached on purpose: joining in a static destructor during DLL unload would deadlock on the loader lock
+    std::thread{ Run }.detach();
+}
+
+void DistrLog::Run() noexcept
+{
+    std::vector<DistrRecord> batch;
+    batch.reserve(capacity);
+
+    while (true) {
+        std::size_t batch_dropped{};
+        {
+            std::unique_lock l{ lock };
+            cv.wait(l, [] { return size > 0; });
+
+            for (; size > 0; --size, head = (head + 1) % capacity) {
+                batch.emplace_back(ring[head]);
+            }
+            std::swap(batch_dropped, dropped);
+        }
+
+        for (const auto& record : batch) {
+            Write(record);
+        }
+        batch.clear();
+
+        if (batch_dropped) {
+            logger::warn("WARNING: Log buffer full, dropped {} distribution messages", batch_dropped);
+        }
+    }
+}
+
+void DistrLog::Write(const DistrRecord& record) noexcept
+{
+    const auto& [type, chance, rule_count, count, ref, container, object, location, location_keyword]{ record };
+
+    // The rule laid out like a parsed DistrObject, so messages read the same as before rules were frozen
+    const auto distr_obj{ [&](const DistrType distr_type) {
+        const auto editor_id{ [](const RE::FormID form_id) { return form_id ? EditorIDs::Find(form_id).value_or("") : ""; } };
+        return std::format("[Type: {} / Container: {:#x} / Bound object: {} ({:#x}) / Count: {} / Location: {} ({:#x}) / Location keyword: {} ({:#x}) / Chance: {}]", distr_type,
+                           container, editor_id(object), object, rule_count, editor_id(location), location, editor_id(location_keyword), location_keyword, chance);
+    } };
+
+    using enum DistrEvent;
+    switch (type) {
+    case Add:
+        logger::info("+ {} / Container ref: {}", distr_obj(DistrType::Add), FormatForm(ref));
+        logger::info("");
+        break;
+    case Remove:
+        logger::info("- {} / Container ref: {}", distr_obj(DistrType::Remove), FormatForm(ref));
+        logger::info("");
+        break;
+    case RemoveAll:
+        logger::info("- {} / Remove all count: {} / Container ref: {}", distr_obj(DistrType::RemoveAll), count, FormatForm(ref));
+        logger::info("");
+        break;
+    case LeveledList:
+        logger::info("Adding {} {} to ref {}", count, FormatForm(object), FormatForm(ref));
+        break;
+    case LeveledListEntry:
+        logger::info("\t+ {} {}", count, FormatForm(object));
+        break;
+    case LeveledListEnd:
+        logger::info("");
+        break;
+    }
+}
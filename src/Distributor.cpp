@@ -1,75 +1,195 @@
 #include "Distributor.h"
 
+#include "DistrLog.h"
+#include "Game.h"
 #include "Map.h"
+#include "RuleTable.h"
+#include "Stats.h"
 #include "Utility.h"
 
-void Distributor::Distribute(RE::TESObjectREFR* a_ref) noexcept
+void Distributor::LocationContext::Resolve() noexcept
 {
-    const auto form_id{ a_ref->GetFormID() };
-    const auto base_form_id{ a_ref->GetBaseObject()->GetFormID() };
+    resolved = true;
+    keywords.clear();
 
-    if (Map::processed_containers.contains(form_id)) {
+    const auto current_location{ Game::GetCurrentLocation(ref) };
+    if (!current_location) {
+        logger::debug("! {} has no current location, skipping its location-conditioned rules", ref);
         return;
     }
 
-    const DistrVecs* to_modify{};
+    location = current_location->GetFormID();
+    for (const auto keyword : std::span{ current_location->keywords, current_location->numKeywords }) {
+        if (keyword) {
+            keywords.emplace_back(keyword->GetFormID());
+        }
+    }
+}
 
-    if (Map::distr_map.contains(form_id)) {
-        to_modify = &Map::distr_map[form_id];
+bool Distributor::LocationContext::Matches(const RuleGroup& group) noexcept
+{
+    if (!resolved) {
+        Resolve();
     }
-    else if (Map::distr_map.contains(base_form_id)) {
-        to_modify = &Map::distr_map[base_form_id];
+
+    if (group.is_keyword ? !std::ranges::contains(keywords, group.key) : group.key != location) {
+        logger::debug("! Skipping {} rules for {}, location {:#x} does not match {} {:#x}", group.rules.size(), ref, location, group.is_keyword ? "keyword" : "location",
+                      group.key);
+        return false;
     }
 
-    if (!to_modify) {
+    return true;
+}
+
+template <typename F>
+void Distributor::ForEachRule(const TypedRules& typed_rules, LocationContext& location_context, F&& func) noexcept
+{
+    thread_local std::vector<std::span<const FrozenRule>> matched;
+    matched.clear();
+
+    if (!typed_rules.unconditional.empty()) {
+        matched.emplace_back(typed_rules.unconditional);
+    }
+    for (const auto& group : typed_rules.groups) {
+        if (location_context.Matches(group)) {
+            matched.emplace_back(group.rules);
+        }
+    }
+
+    if (matched.size() == 1) {
+        for (const auto& rule : matched.front()) {
+            func(rule);
+        }
         return;
     }
 
-    Map::processed_containers.insert(form_id);
+    // Merge the matching groups back into parse order
+    while (!matched.empty()) {
+        const auto next{ std::ranges::min_element(matched, {}, [](const std::span<const FrozenRule> span) { return span.front().index; }) };
+        func(next->front());
+        if (*next = next->subspan(1); next->empty()) {
+            matched.erase(next);
+        }
+    }
+}
 
-    for (const auto& distr_obj : to_modify->to_add) {
-        if (const auto& [type, container, bound_object, count, location, location_keyword, chance]{ distr_obj }; Utility::GetRandomChance() <= chance) {
-            if (Utility::ShouldSkip(a_ref, location, location_keyword)) {
-                continue;
-            }
-            if (const auto lev_item{ bound_object->As<RE::TESLevItem>() }) {
-                Utility::AddObjectsFromResolvedList(a_ref, lev_item, count);
+Distributor::ObjectDelta& Distributor::Plan::GetDelta(RE::TESBoundObject* obj) noexcept
+{
+    const auto [it, inserted]{ delta_indices.try_emplace(obj, static_cast<u32>(deltas.size())) };
+    if (inserted) {
+        deltas.emplace_back(obj);
+    }
+
+    return deltas[it->second];
+}
+
+i32 Distributor::Plan::GetInventoryCount(RE::TESBoundObject* obj) noexcept
+{
+    if (!inv_map) {
+        inv_map = Game::GetInventoryCounts(ref);
+        ++inventory_scans;
+    }
+
+    const auto it{ inv_map->find(obj) };
+    return it != inv_map->end() ? it->second : 0;
+}
+
+template <DistrType type, bool leveled>
+void Distributor::RunKernel(RE::TESObjectREFR* ref, const RE::FormID container, const TypedRules& typed_rules, LocationContext& location_context, Plan& plan) noexcept
+{
+    static_assert(type == DistrType::Add || !leveled, "leveled lists are only distributed by add rules");
+
+    const auto form_id{ ref->GetFormID() };
+
+    ForEachRule(typed_rules, location_context, [&](const FrozenRule& distr_obj) {
+        const auto& [bound_object, location, location_keyword, count, chance, index]{ distr_obj };
+        if (!Utility::RollChance(chance, form_id, type, index)) {
+            return;
+        }
+
+        if constexpr (leveled) {
+            const auto lev_item{ static_cast<RE::TESLevItem*>(bound_object) };
+            DistrLog::Push(DistrEvent::LeveledList, form_id, container, distr_obj, count);
+            for (const auto& [obj, c] : Utility::ResolveLeveledList(lev_item, count)) {
+                plan.GetDelta(obj).added += static_cast<i32>(c);
+                DistrLog::Push({ .type = DistrEvent::LeveledListEntry, .count = c, .ref = form_id, .object = obj->GetFormID() });
             }
-            else {
-                a_ref->AddObjectToContainer(bound_object, nullptr, count, nullptr);
-                Map::added_objects[a_ref].emplace_back(bound_object, count);
-                logger::info("+ {} / Container ref: {}", distr_obj, a_ref);
-                logger::info("");
+            DistrLog::Push({ .type = DistrEvent::LeveledListEnd });
+        }
+        else if constexpr (type == DistrType::Add) {
+            plan.GetDelta(bound_object).added += count;
+            DistrLog::Push(DistrEvent::Add, form_id, container, distr_obj, count);
+        }
+        else if constexpr (type == DistrType::Remove) {
+            plan.GetDelta(bound_object).removed += count;
+            DistrLog::Push(DistrEvent::Remove, form_id, container, distr_obj, count);
+        }
+        else {
+            auto&      delta{ plan.GetDelta(bound_object) };
+            const auto inv_count{ delta.remove_all ? 0 : std::max(plan.GetInventoryCount(bound_object) + delta.added - delta.removed, 0) };
+            if (inv_count <= 0) {
+                logger::error("ERROR: Could not find {} in inventory counts map of {}", bound_object, ref);
+                return;
             }
+            delta.remove_all = true;
+            DistrLog::Push(DistrEvent::RemoveAll, form_id, container, distr_obj, static_cast<u32>(inv_count));
         }
+    });
+}
+
+void Distributor::Distribute(RE::TESObjectREFR* a_ref) noexcept
+{
+    Stats::Timer timer{ Probe::Distribute };
+
+    const auto form_id{ a_ref->GetFormID() };
+    const auto base_form_id{ a_ref->GetBaseObject()->GetFormID() };
+
+    const auto ref_may_have_rules{ RuleTable::MayContain(form_id) };
+    if (!ref_may_have_rules && !RuleTable::MayContain(base_form_id)) {
+        return;
     }
 
-    for (const auto& distr_obj : to_modify->to_remove) {
-        if (const auto& [type, container, bound_object, count, location, location_keyword, chance]{ distr_obj }; Utility::GetRandomChance() <= chance) {
-            if (bound_object->As<RE::TESLevItem>() || Utility::ShouldSkip(a_ref, location, location_keyword)) {
-                continue;
-            }
-            a_ref->RemoveItem(bound_object, count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
-            logger::info("- {} / Container ref: {}", distr_obj, a_ref);
-            logger::info("");
-        }
+    auto container{ form_id };
+    auto to_modify{ ref_may_have_rules ? RuleTable::Find(form_id) : std::nullopt };
+    if (!to_modify) {
+        container = base_form_id;
+        to_modify = RuleTable::Find(base_form_id);
     }
 
-    for (const auto& distr_obj : to_modify->to_remove_all) {
-        if (const auto& [type, container, bound_object, count, location, location_keyword, chance]{ distr_obj }; Utility::GetRandomChance() <= chance) {
-            if (bound_object->As<RE::TESLevItem>() || Utility::ShouldSkip(a_ref, location, location_keyword)) {
-                continue;
-            }
-            const auto inv_map{ a_ref->GetInventoryCounts() };
-            if (!inv_map.contains(bound_object)) {
-                logger::error("ERROR: Could not find {} in inventory counts map of {}", bound_object, a_ref);
-                continue;
-            }
-            const auto inv_count{ inv_map.at(bound_object) };
+    if (!to_modify || !Map::processed_containers.Insert(form_id)) {
+        return;
+    }
 
-            a_ref->RemoveItem(bound_object, inv_count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
-            logger::info("- {} / Remove all count: {} / Container ref: {}", distr_obj, inv_count, a_ref);
-            logger::info("");
+    thread_local std::vector<ObjectDelta>                           deltas;
+    thread_local ankerl::unordered_dense::map<RE::TESBoundObject*, u32> delta_indices;
+    thread_local std::vector<RE::FormID>                            location_keywords;
+    deltas.clear();
+    delta_indices.clear();
+
+    LocationContext location_context{ a_ref, location_keywords };
+    Plan            plan{ a_ref, deltas, delta_indices };
+
+    // Stage 1: evaluate every rule into a net per-object delta. Adds commute, so plain and leveled adds can run as separate kernels before the removals
+
+    RunKernel<DistrType::Add, false>(a_ref, container, to_modify->to_add, location_context, plan);
+    RunKernel<DistrType::Add, true>(a_ref, container, to_modify->to_add_leveled, location_context, plan);
+    RunKernel<DistrType::Remove, false>(a_ref, container, to_modify->to_remove, location_context, plan);
+    RunKernel<DistrType::RemoveAll, false>(a_ref, container, to_modify->to_remove_all, location_context, plan);
+
+    // Stage 2: one engine call per object whose count changes
+
+    for (const auto& [obj, added, removed, remove_all] : deltas) {
+        const auto start_count{ removed > 0 || remove_all ? plan.GetInventoryCount(obj) : 0 };
+        const auto final_count{ remove_all ? 0 : std::max(start_count + added - removed, 0) };
+
+        if (const auto delta{ final_count - start_count }; delta > 0) {
+            Game::AddObject(a_ref, obj, delta);
+            Map::added_objects.Add(form_id, obj->GetFormID(), static_cast<u32>(delta));
+        }
+        else if (delta < 0) {
+            Game::RemoveObject(a_ref, obj, -delta);
         }
     }
+
+    logger::debug("Distributed to {}: {} distinct objects, {} inventory scans", a_ref, deltas.size(), plan.inventory_scans);
 }
@@ -0,0 +1,91 @@
+#include "EditorIDs.h"
+
+#include "Game.h"
+
+void EditorIDs::SetRuleForms(const std::span<const RE::FormID> form_ids) noexcept
+{
+    std::unique_lock l{ lock };
+
+    rule_forms.clear();
+    rule_forms.insert(form_ids.begin(), form_ids.end());
+    table.clear();
+}
+
+void EditorIDs::AddRuleForms(const std::span<const RE::FormID> form_ids) noexcept
+{
+    std::unique_lock l{ lock };
+
+    rule_forms.insert(form_ids.begin(), form_ids.end());
+}
+
+std::string EditorIDs::Get(const RE::TESForm* form) noexcept
+{
+    if (!form) {
+        return "";
+    }
+
+    const auto form_id{ form->GetFormID() };
+    {
+        std::shared_lock l{ lock };
+        if (const auto it{ table.find(form_id) }; it != table.end()) {
+            return it->second;
+        }
+        if (!rule_forms.contains(form_id)) {
+            l.unlock();
+            const auto editor_id{ Game::GetEditorID(form) };
+            return editor_id ? editor_id : "";
+        }
+    }
+
+    const auto editor_id{ Game::GetEditorID(form) };
+
+    std::unique_lock l{ lock };
+
+    return table.try_emplace(form_id, editor_id ? editor_id : "").first->second;
+}
+
+void EditorIDs::Intern(const RE::TESForm* form) noexcept
+{
+    if (!form) {
+        return;
+    }
+
+    {
+        std::shared_lock l{ lock };
+        if (table.contains(form->GetFormID()) || !rule_forms.contains(form->GetFormID())) {
+            return;
+        }
+    }
+
+    static_cast<void>(Get(form));
+}
+
+std::optional<std::string> EditorIDs::Find(const RE::FormID form_id) noexcept
+{
+    std::shared_lock l{ lock };
+    if (const auto it{ table.find(form_id) }; it != table.end()) {
+        return it->second;
+    }
+
+    return std::nullopt;
+}
+
+std::size_t EditorIDs::Size() noexcept
+{
+    std::shared_lock l{ lock };
+
+    return table.size();
+}
+
+std::size_t EditorIDs::MemoryUsage() noexcept
+{
+    std::shared_lock l{ lock };
+
+    std::size_t bytes{ table.values().capacity() * sizeof(decltype(table)::value_type) + table.bucket_count() * sizeof(u64) + rule_forms.values().capacity() * sizeof(RE::FormID) +
+                       rule_forms.bucket_count() * sizeof(u64) };
+    for (const auto& [form_id, editor_id] : table) {
+        bytes += editor_id.capacity();
+    }
+
+    return bytes;
+}
@@ -1,15 +1,38 @@
 #include "Events.h"
 
 #include "Map.h"
+#include "Scheduler.h"
 
 namespace Events
 {
     RE::BSEventNotifyControl LoadGameEventHandler::ProcessEvent(const RE::TESLoadGameEvent* a_event, RE::BSTEventSource<RE::TESLoadGameEvent>* a_eventSource) noexcept
     {
-        logger::debug("LoadGameEventHandler: Clearing processed_containers and added_objects");
+        logger::debug("LoadGameEventHandler: Clearing processed_containers, added_objects ({} refs, {} bytes, {} free nodes) and the scheduler queue ({} refs)",
+                      Map::added_objects.Size(), Map::added_objects.MemoryUsage(), Map::added_objects.FreeNodes(), Scheduler::QueueDepth());
 
-        Map::processed_containers.clear();
-        Map::added_objects.clear();
+        Map::processed_containers.Clear();
+        Map::added_objects.Clear();
+        Scheduler::Clear();
+
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    RE::BSEventNotifyControl FormDeleteEventHandler::ProcessEvent(const RE::TESFormDeleteEvent* a_event, RE::BSTEventSource<RE::TESFormDeleteEvent>* a_eventSource) noexcept
+    {
+        if (a_event) {
+            Map::added_objects.Erase(a_event->formID);
+            Map::processed_containers.Erase(a_event->formID);
+            Map::respawn_containers.Erase(a_event->formID);
+        }
+
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    RE::BSEventNotifyControl CrosshairRefEventHandler::ProcessEvent(const SKSE::CrosshairRefEvent* a_event, RE::BSTEventSource<SKSE::CrosshairRefEvent>* a_eventSource) noexcept
+    {
+        if (a_event && a_event->crosshairRef) {
+            Scheduler::Flush(a_event->crosshairRef.get());
+        }
 
         return RE::BSEventNotifyControl::kContinue;
     }
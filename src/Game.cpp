@@ -0,0 +1,151 @@
+#include "Game.h"
+
+#include "Map.h"
+
+RE::TESForm* Game::LookupByID(const RE::FormID form_id) noexcept
+{
+    return RE::TESForm::LookupByID(form_id);
+}
+
+RE::TESForm* Game::LookupByEditorID(const std::string_view editor_id) noexcept
+{
+    // The engine builds its BSFixedString key from a C string, and identifiers are views into the INI file buffer that run on to the end of the line
+    const std::string key{ editor_id };
+
+    return RE::TESForm::LookupByEditorID(key);
+}
+
+const char* Game::GetEditorID(const RE::TESForm* form) noexcept
+{
+    using TGetFormEditorID = const char* (*)(u32);
+
+    using enum RE::FormType;
+    switch (form->GetFormType()) {
+    case Keyword:
+    case LocationRefType:
+    case Action:
+    case MenuIcon:
+    case Global:
+    case HeadPart:
+    case Race:
+    case Sound:
+    case Script:
+    case Navigation:
+    case Cell:
+    case WorldSpace:
+    case Land:
+    case NavMesh:
+    case Dialogue:
+    case Quest:
+    case Idle:
+    case AnimatedObject:
+    case ImageAdapter:
+    case VoiceType:
+    case Ragdoll:
+    case DefaultObject:
+    case MusicType:
+    case StoryManagerBranchNode:
+    case StoryManagerQuestNode:
+    case StoryManagerEventNode:
+    case SoundRecord:            return form->GetFormEditorID();
+    default:                     {
+        static auto po3_tweaks{ REX::W32::GetModuleHandleW(L"po3_Tweaks") };
+        static auto func{ reinterpret_cast<TGetFormEditorID>(REX::W32::GetProcAddress(po3_tweaks, "GetFormEditorID")) };
+        if (func) {
+            return func(form->formID);
+        }
+        return "";
+    }
+    }
+}
+
+std::vector<PluginInfo> Game::GetPlugins() noexcept
+{
+    std::vector<PluginInfo> plugins;
+
+    if (const auto handler{ RE::TESDataHandler::GetSingleton() }) {
+        for (const auto file : handler->files) {
+            if (!file || file->GetCompileIndex() == 0xFF) {
+                continue;
+            }
+            plugins.emplace_back(std::string{ file->GetFilename() }, file->GetCompileIndex(), file->GetSmallFileCompileIndex(), file->IsLight());
+        }
+    }
+
+    return plugins;
+}
+
+void Game::CalculateLeveledList(RE::TESLevItem* leveled_list, const u32 count, std::vector<ObjectAndCount>& out) noexcept
+{
+    const auto player{ RE::PlayerCharacter::GetSingleton() };
+    if (!player) {
+        logger::error("\t\tERROR: Failed to find player level for resolving leveled list {} ({:#x})", GetFormEditorID(leveled_list), leveled_list->GetFormID());
+        return;
+    }
+
+    RE::BSScrapArray<RE::CALCED_OBJECT> calced_objects;
+    leveled_list->CalculateCurrentFormList(player->GetLevel(), static_cast<i16>(count), calced_objects, 0, true);
+
+    for (const auto& c : calced_objects) {
+        if (const auto bound_obj{ c.form->As<RE::TESBoundObject>() }) {
+            out.emplace_back(bound_obj, c.count);
+        }
+    }
+}
+
+RE::BGSLocation* Game::GetCurrentLocation(RE::TESObjectREFR* ref) noexcept
+{
+    return ref->GetCurrentLocation();
+}
+
+RE::TESObjectREFR::InventoryCountMap Game::GetInventoryCounts(RE::TESObjectREFR* ref) noexcept
+{
+    return ref->GetInventoryCounts();
+}
+
+void Game::AddObject(RE::TESObjectREFR* ref, RE::TESBoundObject* obj, const i32 count) noexcept
+{
+    ref->AddObjectToContainer(obj, nullptr, count, nullptr);
+}
+
+void Game::RemoveObject(RE::TESObjectREFR* ref, RE::TESBoundObject* obj, const i32 count) noexcept
+{
+    ref->RemoveItem(obj, count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
+}
+
+bool Game::Is3DLoaded(const RE::TESObjectREFR* ref) noexcept
+{
+    return ref->Is3DLoaded();
+}
+
+bool Game::IsDetached(const RE::TESObjectREFR* ref) noexcept
+{
+    const auto cell{ ref->GetParentCell() };
+
+    return ref->IsDeleted() || ref->IsDisabled() || !cell || !cell->IsAttached();
+}
+
+std::filesystem::path Game::GetDataDirectory() noexcept
+{
+    return R"(.\Data)";
+}
+
+std::optional<std::filesystem::path> Game::GetLogDirectory() noexcept
+{
+    return SKSE::log::log_directory();
+}
+
+std::string_view Game::GetPluginName() noexcept
+{
+    return SKSE::PluginDeclaration::GetSingleton()->GetName();
+}
+
+std::string Game::GetPluginVersion() noexcept
+{
+    return SKSE::PluginDeclaration::GetSingleton()->GetVersion().string();
+}
+
+void Game::Fail(const std::string_view message) noexcept
+{
+    stl::report_and_fail(std::format("{}: {}", GetPluginName(), message));
+}
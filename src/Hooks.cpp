@@ -1,7 +1,8 @@
 #include "Hooks.h"
 
-#include "Distributor.h"
 #include "Map.h"
+#include "Scheduler.h"
+#include "Stats.h"
 
 namespace Hooks
 {
@@ -18,56 +19,131 @@ namespace Hooks
 
         stl::write_vfunc<RE::TESObjectREFR, SaveGame>();
         logger::info("Installed TESObjectREFR::SaveGame hook");
+
+        stl::write_vfunc<RE::PlayerCharacter, PlayerUpdate>();
+        logger::info("Installed PlayerCharacter::Update hook");
+
+        stl::write_vfunc<RE::TESObjectCONT, ActivateContainer>();
+        logger::info("Installed TESObjectCONT::Activate hook");
+
+        stl::write_vfunc<RE::TESNPC, ActivateActor>();
+        logger::info("Installed TESNPC::Activate hook");
         logger::info("");
     }
 
     RE::NiAVObject* Load3D::Thunk(RE::TESObjectREFR* a_this, bool a_backgroundLoading) noexcept
     {
+        Stats::Timer timer{ Probe::Load3D };
+
         if (a_this && a_this->HasContainer()) {
             if (const auto cont{ a_this->GetBaseObject()->As<RE::TESObjectCONT>() }) {
                 if (cont->data.flags & RE::CONT_DATA::Flag::kRespawn) {
-                    Map::respawn_containers.insert(a_this->GetFormID());
+                    Map::respawn_containers.Insert(a_this->GetFormID());
                 }
             }
-            Distributor::Distribute(a_this);
+            Scheduler::Enqueue(a_this);
         }
-        return func(a_this, a_backgroundLoading);
+        return timer.Exclude([&] { return func(a_this, a_backgroundLoading); });
     }
 
     RE::NiAVObject* Load3DCharacter::Thunk(RE::Character* a_this, bool a_backgroundLoading) noexcept
     {
+        Stats::Timer timer{ Probe::Load3DCharacter };
+
         if (a_this && a_this->HasContainer()) {
-            Distributor::Distribute(a_this);
+            Scheduler::Enqueue(a_this);
         }
 
-        return func(a_this, a_backgroundLoading);
+        return timer.Exclude([&] { return func(a_this, a_backgroundLoading); });
     }
 
     void ResetInventory::Thunk(RE::TESObjectREFR* a_this, bool a_leveledOnly) noexcept
     {
-        func(a_this, a_leveledOnly);
+        Stats::Timer timer{ Probe::ResetInventory };
+
+        timer.Exclude([&] { func(a_this, a_leveledOnly); });
 
-        if (a_this && Map::respawn_containers.contains(a_this->GetFormID())) {
-            Map::processed_containers.erase(a_this->GetFormID());
-            Distributor::Distribute(a_this);
+        if (a_this) {
+            Scheduler::OnResetInventory(a_this, a_leveledOnly);
         }
     }
 
     void SaveGame::Thunk(RE::TESObjectREFR* a_this, RE::BGSSaveFormBuffer* a_buf) noexcept
     {
-        if (!Map::processed_containers.contains(a_this->GetFormID()) || !Map::added_objects.contains(a_this)) {
-            func(a_this, a_buf);
+        Stats::Timer timer{ Probe::SaveGame };
+
+        const auto form_id{ a_this->GetFormID() };
+        const auto changes{ a_this->GetInventoryChanges() };
+
+        if (!changes || !changes->entryList || !Map::processed_containers.Contains(form_id) || !Map::added_objects.Contains(form_id)) {
+            timer.Exclude([&] { func(a_this, a_buf); });
             return;
         }
 
-        logger::debug("Removing added objects from {}", a_this);
+        logger::debug("Leaving added objects of {} out of the save", a_this);
 
-        for (const auto& [obj, count] : Map::added_objects[a_this]) {
-            a_this->RemoveItem(obj, count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
-            logger::debug("\tRemoved {} ({})", obj, count);
+        // The engine writes each entry's count delta, so lowering it around the write keeps added objects out of the save without an inventory change: nothing is
+        // unequipped and no events fire. Only plain copies can be left out, worn or otherwise modified ones live in extra data lists that are written as they are
+        thread_local std::vector<std::pair<RE::InventoryEntryData*, i32>> filtered;
+        filtered.clear();
+
+        const auto container{ a_this->GetContainer() };
+
+        Map::added_objects.ForEach(form_id, [&](const AddedObjects::Record& record) {
+            for (const auto entry : *changes->entryList) {
+                if (!entry || !entry->object || entry->object->GetFormID() != record.obj) {
+                    continue;
+                }
+
+                i32 in_extra_lists{};
+                if (entry->extraLists) {
+                    for (const auto extra_list : *entry->extraLists) {
+                        in_extra_lists += extra_list ? extra_list->GetCount() : 0;
+                    }
+                }
+
+                const auto plain_count{ (container ? container->CountObjectsInContainer(entry->object) : 0) + entry->countDelta - in_extra_lists };
+                if (const auto count{ std::min({ static_cast<i32>(record.count), entry->countDelta, plain_count }) }; count > 0) {
+                    entry->countDelta -= count;
+                    filtered.emplace_back(entry, count);
+                    logger::debug("\tLeft out {} ({})", entry->object, count);
+                }
+                break;
+            }
+        });
+
+        timer.Exclude([&] { func(a_this, a_buf); });
+
+        for (const auto& [entry, count] : filtered) {
+            entry->countDelta += count;
+        }
+    }
+
+    void PlayerUpdate::Thunk(RE::PlayerCharacter* a_this, float a_delta) noexcept
+    {
+        func(a_this, a_delta);
+
+        Scheduler::RunFrame();
+    }
+
+    bool ActivateContainer::Thunk(RE::TESObjectCONT* a_this, RE::TESObjectREFR* a_targetRef, RE::TESObjectREFR* a_activatorRef, u8 a_arg3, RE::TESBoundObject* a_object,
+                                  i32 a_targetCount) noexcept
+    {
+        if (a_targetRef) {
+            Scheduler::Flush(a_targetRef);
+        }
+
+        return func(a_this, a_targetRef, a_activatorRef, a_arg3, a_object, a_targetCount);
+    }
+
+    bool ActivateActor::Thunk(RE::TESNPC* a_this, RE::TESObjectREFR* a_targetRef, RE::TESObjectREFR* a_activatorRef, u8 a_arg3, RE::TESBoundObject* a_object,
+                              i32 a_targetCount) noexcept
+    {
+        if (a_targetRef) {
+            Scheduler::Flush(a_targetRef);
         }
 
-        func(a_this, a_buf);
+        return func(a_this, a_targetRef, a_activatorRef, a_arg3, a_object, a_targetCount);
     }
 
 } // namespace Hooks
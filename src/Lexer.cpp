@@ -0,0 +1,96 @@
+#include "Lexer.h"
+
+#include "ParseLog.h"
+
+bool Lexer::LoadFile(const std::filesystem::path& path, std::vector<char>& buffer) noexcept
+{
+    std::error_code ec{};
+    const auto      size{ std::filesystem::file_size(path, ec) };
+    if (ec) {
+        ParseLog::error("ERROR: Failed to get size of {} ({})", path.filename().string(), ec.message());
+        return false;
+    }
+
+    std::ifstream file{ path, std::ios::binary };
+    if (!file) {
+        ParseLog::error("ERROR: Failed to open {}", path.filename().string());
+        return false;
+    }
+
+    buffer.resize(size);
+    if (!file.read(buffer.data(), static_cast<std::streamsize>(size))) {
+        ParseLog::error("ERROR: Failed to read {}", path.filename().string());
+        buffer.clear();
+        return false;
+    }
+
+    return true;
+}
+
+std::string_view Lexer::Trim(std::string_view s) noexcept
+{
+    constexpr auto whitespace{ " \t\r\n\v\f"sv };
+
+    const auto first{ s.find_first_not_of(whitespace) };
+    if (first == std::string_view::npos) {
+        return {};
+    }
+
+    return s.substr(first, s.find_last_not_of(whitespace) - first + 1);
+}
+
+int Lexer::CompareNoCase(const std::string_view lhs, const std::string_view rhs) noexcept
+{
+    // Same ordering as SimpleIni's SI_NoCase: ASCII-only lowercasing, compared as (signed) char
+    constexpr auto lower{ [](const char c) { return c < 'A' || c > 'Z' ? c : static_cast<char>(c - 'A' + 'a'); } };
+
+    const auto n{ std::min(lhs.size(), rhs.size()) };
+    for (std::size_t i{}; i < n; ++i) {
+        if (const auto diff{ lower(lhs[i]) - lower(rhs[i]) }; diff != 0) {
+            return diff;
+        }
+    }
+
+    return lhs.size() < rhs.size() ? -1 : lhs.size() > rhs.size() ? 1 : 0;
+}
+
+std::vector<KeyValue> Lexer::LexGeneral(std::string_view text) noexcept
+{
+    if (text.starts_with("\xEF\xBB\xBF"sv)) {
+        text.remove_prefix(3);
+    }
+
+    std::vector<KeyValue> result;
+    auto                  in_general{ false };
+
+    while (!text.empty()) {
+        const auto eol{ text.find('\n') };
+        const auto line{ Trim(text.substr(0, eol)) };
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+        if (line.empty() || line.front() == ';' || line.front() == '#') {
+            continue;
+        }
+
+        if (line.front() == '[') {
+            const auto close{ line.find(']') };
+            in_general = close != std::string_view::npos && CompareNoCase(Trim(line.substr(1, close - 1)), "General"sv) == 0;
+            continue;
+        }
+
+        if (!in_general) {
+            continue;
+        }
+
+        const auto eq{ line.find('=') };
+        if (eq == std::string_view::npos) {
+            continue;
+        }
+
+        result.emplace_back(Trim(line.substr(0, eq)), Trim(line.substr(eq + 1)));
+    }
+
+    std::ranges::stable_sort(result, [](const KeyValue& a, const KeyValue& b) { return CompareNoCase(a.key, b.key) < 0; });
+
+    return result;
+}
@@ -1,7 +1,10 @@
+#include "DistrLog.h"
 #include "Events.h"
 #include "Hooks.h"
 #include "Parser.h"
 #include "Settings.h"
+#include "Stats.h"
+#include "Watcher.h"
 
 void Listener(SKSE::MessagingInterface::Message* message) noexcept
 {
@@ -11,9 +14,14 @@ void Listener(SKSE::MessagingInterface::Message* message) noexcept
             stl::report_and_fail("ERROR [ContainerItemDistributor.dll]: powerofthree's Tweaks not found");
         }
         Settings::LoadSettings();
+        DistrLog::Start();
+        Stats::Start();
         Parser::ParseINIs();
+        Watcher::Start();
         Hooks::Install();
         Events::LoadGameEventHandler::Register();
+        Events::FormDeleteEventHandler::Register();
+        Events::CrosshairRefEventHandler::Register();
     }
 }
 
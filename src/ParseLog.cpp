@@ -0,0 +1,9 @@
+#include "ParseLog.h"
+
+void ParseLog::Write(const Messages& messages) noexcept
+{
+    const auto log{ spdlog::default_logger_raw() };
+    for (const auto& [level, text] : messages) {
+        log->log(level, text);
+    }
+}
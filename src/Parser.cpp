@@ -1,29 +1,59 @@
 #include "Parser.h"
 
+#include "Cache.h"
+#include "Game.h"
+#include "Lexer.h"
+#include "ParseLog.h"
+#include "Resolver.h"
+#include "RuleTable.h"
+#include "Settings.h"
+#include "Stats.h"
 #include "Utility.h"
 
 DistrType Parser::ClassifyString(const std::string_view s) noexcept
+{
+    thread_local DelimiterMask mask;
+    mask.Scan(s);
+
+    return ClassifyString(s, mask);
+}
+
+DistrType Parser::ClassifyString(const std::string_view s, const DelimiterMask& mask) noexcept
 {
     const auto has_leading_minus{ s.starts_with('-') };
-    const auto bar_count{ std::ranges::count(s, '|') };
+    const auto has_bar{ mask.Find(Delimiter::Bar, 0, s.size()) != std::string_view::npos };
 
-    if (!has_leading_minus && bar_count > 0) {
+    if (!has_leading_minus && has_bar) {
         return DistrType::Add;
     }
-    if (has_leading_minus && bar_count > 0) {
+    if (has_leading_minus && has_bar) {
         return DistrType::Remove;
     }
-    if (has_leading_minus && bar_count == 0) {
+    if (has_leading_minus && !has_bar) {
         return DistrType::RemoveAll;
     }
 
     return DistrType::Error;
 }
 
-DistrToken Parser::Tokenize(std::string s, const std::string& to_container, const DistrType distr_type) noexcept
+DistrToken Parser::Tokenize(const std::string_view s, const std::string_view to_container, const DistrType distr_type) noexcept
 {
-    auto max_split_size{ 4 };
-    auto min_split_size{ 2 };
+    thread_local DelimiterMask mask;
+    mask.Scan(s);
+
+    return Tokenize(s, to_container, distr_type, mask);
+}
+
+DistrToken Parser::Tokenize(const std::string_view s, const std::string_view to_container, const DistrType distr_type, const DelimiterMask& mask) noexcept
+{
+    auto max_split_size{ 4U };
+    auto min_split_size{ 2U };
+
+    const DistrToken error_token{ .type = DistrType::Error, .to_identifier = to_container, .identifier = "", .count = 0, .location = "", .location_keyword = "", .chance = 0 };
+
+    // Positions below are indices into s, which the mask was built from
+    std::size_t begin{};
+    auto        end{ s.size() };
 
     using enum DistrType;
     switch (distr_type) {
@@ -31,65 +61,91 @@ DistrToken Parser::Tokenize(std::string s, const std::string& to_container, cons
         break;
     }
     case Remove: {
-        s.erase(0, 1);
+        begin = 1;
         break;
     }
     case RemoveAll: {
-        s.erase(0, 1);
+        begin          = 1;
         max_split_size = 3;
         min_split_size = 1;
         break;
     }
     default:
-        logger::error("ERROR: Failed to tokenize {}", s);
+        ParseLog::error("ERROR: Failed to tokenize {}", s);
 
-        return { .type = Error, .to_identifier = to_container, .identifier = "", .count = 0, .location = "", .location_keyword = "", .chance = 0 };
+        return error_token;
     }
 
-    const auto chance_sep{ s.rfind('?') };
-    u16        chance{ 100U };
-    if (chance_sep != std::string::npos) {
-        chance = Map::ToUnsignedInt(s.substr(chance_sep + 1));
-        s.erase(chance_sep);
+    u16 chance{ 100U };
+    if (const auto chance_sep{ mask.RFind(Delimiter::Question, begin, end) }; chance_sep != std::string_view::npos) {
+        if (const auto parsed{ Map::ToUnsignedInt(Lexer::Trim(s.substr(chance_sep + 1, end - chance_sep - 1))) }) {
+            chance = *parsed;
+        }
+        else {
+            ParseLog::error("ERROR: {} has an invalid chance", s.substr(begin, end - begin));
+
+            return error_token;
+        }
+        end = chance_sep;
     }
 
-    const auto  location_keyword_sep{ s.rfind('@') };
-    std::string location_keyword{};
-    if (location_keyword_sep != std::string::npos) {
-        location_keyword = s.substr(location_keyword_sep + 1);
-        s.erase(location_keyword_sep);
+    std::string_view location_keyword{};
+    if (const auto location_keyword_sep{ mask.RFind(Delimiter::At, begin, end) }; location_keyword_sep != std::string_view::npos) {
+        location_keyword = s.substr(location_keyword_sep + 1, end - location_keyword_sep - 1);
+        end              = location_keyword_sep;
     }
 
-    const auto split{ s | std::ranges::views::split('|') | std::ranges::to<std::vector<std::string>>() };
+    std::array<std::string_view, 4> split{};
+    auto                            split_size{ 0U };
+    for (auto pos{ begin };; ++split_size) {
+        const auto bar{ mask.Find(Delimiter::Bar, pos, end) };
+        if (split_size < split.size()) {
+            split[split_size] = s.substr(pos, (bar == std::string_view::npos ? end : bar) - pos);
+        }
+        if (bar == std::string_view::npos) {
+            ++split_size;
+            break;
+        }
+        pos = bar + 1;
+    }
+
+    if (split_size > max_split_size || split_size < min_split_size) {
+        ParseLog::error("ERROR: {} is ill-formed", s.substr(begin, end - begin));
+
+        return error_token;
+    }
 
-    if (split.size() > max_split_size || split.size() < min_split_size) {
-        logger::error("ERROR: {} is ill-formed", s);
+    u16 count{};
+    if (distr_type != RemoveAll) {
+        if (const auto parsed{ Map::ToUnsignedInt(Lexer::Trim(split[1])) }) {
+            count = *parsed;
+        }
+        else {
+            ParseLog::error("ERROR: {} has an invalid count", s.substr(begin, end - begin));
 
-        return { .type = Error, .to_identifier = to_container, .identifier = "", .count = 0, .location = "", .location_keyword = "", .chance = 0 };
+            return error_token;
+        }
     }
 
     return { .type             = distr_type,
              .to_identifier    = to_container,
              .identifier       = split[0],
-             .count            = distr_type != RemoveAll ? Map::ToUnsignedInt(split[1]) : static_cast<u16>(0U),
-             .location         = split.size() > 2 ? split[2] : "",
+             .count            = count,
+             .location         = split_size > 2 ? split[2] : "",
              .location_keyword = location_keyword,
              .chance           = chance };
 }
 
-void Parser::ParseINIs() noexcept
+std::vector<std::filesystem::path> Parser::FindINIs() noexcept
 {
-    const std::filesystem::path data_dir{ R"(.\Data)" };
-    const auto                  pattern{ L"_CID.ini" };
+    const auto data_dir{ Game::GetDataDirectory() };
+    const auto pattern{ L"_CID.ini" };
 
     if (!exists(data_dir)) {
         logger::error("ERROR: Failed to find Data directory");
-        stl::report_and_fail(std::format("{}: Failed to find Data directory", SKSE::PluginDeclaration::GetSingleton()->GetName()));
+        Game::Fail("Failed to find Data directory");
     }
 
-    logger::info(">------------------------------------------------------------ Parsing _CID.ini files... -------------------------------------------------------------<");
-    logger::info("");
-
     std::vector<std::filesystem::path> cid_inis;
     for (std::error_code ec{}; const auto& file : std::filesystem::directory_iterator{ data_dir, ec }) {
         if (ec.value()) {
@@ -112,68 +168,233 @@ void Parser::ParseINIs() noexcept
 
     std::sort(std::execution::par, cid_inis.begin(), cid_inis.end());
 
-    for (const auto& f : cid_inis) {
-        CSimpleIniA ini;
-        ini.SetUnicode();
-        ini.SetMultiKey();
+    return cid_inis;
+}
+
+ParsedINI Parser::ReadINI(const std::filesystem::path& path) noexcept
+{
+    const auto filename{ path.filename().string() };
 
-        const auto filename{ f.filename().string() };
+    ParseLog::info("Loading config file: {}", filename);
+
+    ParsedINI parsed{};
+    {
+        Stats::Timer timer{ Probe::ParseINILoad };
+        if (!Lexer::LoadFile(path, parsed.buffer)) {
+            return parsed;
+        }
+    }
 
-        logger::info("Loading config file: {}", filename);
+    Stats::Timer timer{ Probe::ParseTokenize };
 
-        ini.LoadFile(f.wstring().data());
+    const auto key_values{ Lexer::LexGeneral({ parsed.buffer.data(), parsed.buffer.size() }) };
 
-        CSimpleIniA::TNamesDepend keys{};
-        ini.GetAllKeys("General", keys);
+    ParseLog::debug("");
+    ParseLog::debug("{} has {} values", filename, key_values.size());
 
-        logger::debug("");
-        logger::debug("{} has {} keys", filename, keys.size());
+    parsed.tokens.reserve(key_values.size());
 
-        for (const auto& k : keys) {
-            CSimpleIniA::TNamesDepend values{};
-            ini.GetAllValues("General", k.pItem, values);
+    // One delimiter scan per value, shared by classification and tokenization
+    thread_local DelimiterMask mask;
 
-            logger::debug("\tKey {} has {} values:", k.pItem, values.size());
+    std::string_view key{};
+    for (const auto& [k, v] : key_values) {
+        // Keys that only differ in case are one key to SimpleIni, which reports them under the first spelling
+        if (key.empty() || Lexer::CompareNoCase(key, k) != 0) {
+            key = k;
+            ParseLog::debug("\tKey {}:", key);
+        }
 
-            for (const auto& v : values) {
-                const auto& distr_type{ ClassifyString(v.pItem) };
-                logger::debug("\t\t* {} {}", distr_type, v.pItem);
+        mask.Scan(v);
 
-                const auto distr_obj{ Utility::BuildDistrObject(Tokenize(v.pItem, k.pItem, distr_type)) };
+        const auto distr_type{ ClassifyString(v, mask) };
+        ParseLog::debug("\t\t* {} {}", distr_type, v);
 
-                if (distr_obj.type == DistrType::Error) {
-                    continue;
-                }
+        if (const auto token{ Tokenize(v, key, distr_type, mask) }; token.type != DistrType::Error) {
+            parsed.tokens.emplace_back(token);
+        }
+    }
+    ParseLog::debug("");
 
-                if (distr_obj.location && distr_obj.location_keyword) {
-                    logger::error("\t\tERROR: {:?} contains both location and location_keyword. Please only define one or the other", v.pItem);
-                    continue;
-                }
+    return parsed;
+}
 
-                const auto cont_form_id{ distr_obj.container_form_id };
+std::vector<DistrObject> Parser::BuildRules(const std::vector<DistrToken>& tokens, const u16 file) noexcept
+{
+    Stats::Timer timer{ Probe::ParseResolve };
 
-                using enum DistrType;
-                switch (distr_obj.type) {
-                case Add:
-                    Map::distr_map[cont_form_id].to_add.emplace_back(distr_obj);
-                    break;
-                case Remove:
-                    Map::distr_map[cont_form_id].to_remove.emplace_back(distr_obj);
-                    break;
-                case RemoveAll:
-                    Map::distr_map[cont_form_id].to_remove_all.emplace_back(distr_obj);
-                    break;
-                default:
-                    break;
-                }
-            }
+    std::vector<DistrObject> rules;
+    rules.reserve(tokens.size());
+
+    for (const auto& token : tokens) {
+        auto distr_obj{ Utility::BuildDistrObject(token) };
+
+        if (distr_obj.type == DistrType::Error) {
+            continue;
+        }
+
+        if (distr_obj.location && distr_obj.location_keyword) {
+            ParseLog::error("\t\tERROR: {} contains both location and location_keyword. Please only define one or the other", token);
+            continue;
+        }
+
+        distr_obj.file = file;
+        rules.emplace_back(distr_obj);
+    }
+
+    return rules;
+}
+
+void Parser::AddRules(const std::vector<DistrObject>& rules) noexcept
+{
+    for (const auto& distr_obj : rules) {
+        const auto cont_form_id{ distr_obj.container_form_id };
+
+        using enum DistrType;
+        switch (distr_obj.type) {
+        case Add:
+            Map::distr_map[cont_form_id].to_add.emplace_back(distr_obj);
+            break;
+        case Remove:
+            Map::distr_map[cont_form_id].to_remove.emplace_back(distr_obj);
+            break;
+        case RemoveAll:
+            Map::distr_map[cont_form_id].to_remove_all.emplace_back(distr_obj);
+            break;
+        default:
+            break;
         }
-        logger::debug("");
+    }
+}
 
-        ini.Reset();
+void Parser::ParseINIs() noexcept
+{
+    logger::info(">------------------------------------------------------------ Parsing _CID.ini files... -------------------------------------------------------------<");
+    logger::info("");
+
+    const auto cid_inis{ [] {
+        Stats::Timer timer{ Probe::ParseDirectoryScan };
+        return FindINIs();
+    }() };
+    const auto fingerprint{ Settings::use_cache ? Cache::Fingerprint(cid_inis) : 0x0ULL };
+
+    Map::source_files = cid_inis;
+
+    if (const auto cached_rules{ Settings::use_cache ? Cache::Load(fingerprint) : std::nullopt }) {
+        AddRules(*cached_rules);
     }
+    else {
+        Resolver::Reset();
+
+        // Files are read and resolved independently, then merged in sorted filename order so distr_map and the log are the same as with a serial parse
+        std::vector<std::vector<DistrObject>> rules_per_file(cid_inis.size());
+        std::vector<ParseLog::Messages>       logs_per_file(cid_inis.size());
+        std::transform(std::execution::par, cid_inis.begin(), cid_inis.end(), rules_per_file.begin(), [&](const std::filesystem::path& f) {
+            const auto              file{ static_cast<u16>(&f - cid_inis.data()) };
+            const ParseLog::Capture capture{ logs_per_file[file] };
+            return BuildRules(ReadINI(f).tokens, file);
+        });
+
+        for (std::size_t i{}; i < rules_per_file.size(); ++i) {
+            ParseLog::Write(logs_per_file[i]);
+            AddRules(rules_per_file[i]);
+        }
+
+        Resolver::LogStats();
+
+        if (Settings::use_cache) {
+            Cache::Save(fingerprint, rules_per_file);
+        }
+    }
+
+    RuleTable::Freeze();
 
     logger::info("");
     logger::info(">--------------------------------------------------------- Finished parsing _CID.ini files ----------------------------------------------------------<");
     logger::info("");
 }
+
+void Parser::ReloadINIs(const std::vector<std::filesystem::path>& changed) noexcept
+{
+    logger::info(">----------------------------------------------------------- Reloading _CID.ini files... ------------------------------------------------------------<");
+    logger::info("");
+
+    const auto start{ std::chrono::steady_clock::now() };
+
+    // Plugins cannot change at runtime, so resolved identifiers stay valid. The plugin table is only missing if the rules came from the cache
+    if (!Resolver::IsReady()) {
+        Resolver::Reset();
+    }
+
+    ankerl::unordered_dense::set<u16>        changed_files;
+    ankerl::unordered_dense::set<RE::FormID> affected;
+
+    for (const auto& path : changed) {
+        auto it{ std::ranges::find(Map::source_files, path) };
+        if (it == Map::source_files.end()) {
+            if (Map::source_files.size() > std::numeric_limits<u16>::max()) {
+                logger::error("ERROR: Too many _CID.ini files, not loading {}", path.filename().string());
+                continue;
+            }
+            it = Map::source_files.insert(Map::source_files.end(), path);
+        }
+        changed_files.insert(static_cast<u16>(it - Map::source_files.begin()));
+    }
+
+    // Drop everything the changed files contributed
+    const auto from_changed_file{ [&](const DistrObject& distr_obj) { return changed_files.contains(distr_obj.file); } };
+    for (auto& [form_id, distr_vecs] : Map::distr_map) {
+        auto& [to_add, to_remove, to_remove_all]{ distr_vecs };
+        if (std::erase_if(to_add, from_changed_file) + std::erase_if(to_remove, from_changed_file) + std::erase_if(to_remove_all, from_changed_file) > 0) {
+            affected.insert(form_id);
+        }
+    }
+
+    // Removed files simply contribute nothing now
+    for (const auto file : changed_files) {
+        if (const auto& path{ Map::source_files[file] }; exists(path)) {
+            const auto rules{ BuildRules(ReadINI(path).tokens, file) };
+            for (const auto& distr_obj : rules) {
+                affected.insert(distr_obj.container_form_id);
+            }
+            AddRules(rules);
+        }
+        else {
+            logger::info("Removed config file: {}", path.filename().string());
+        }
+    }
+
+    // Appended rules go back to sorted filename order, so the result matches a full parse
+    std::vector<u32> rank(Map::source_files.size());
+    {
+        std::vector<u32> order(Map::source_files.size());
+        std::iota(order.begin(), order.end(), 0U);
+        std::ranges::sort(order, {}, [](const u32 i) -> const std::filesystem::path& { return Map::source_files[i]; });
+        for (u32 i{}; i < order.size(); ++i) {
+            rank[order[i]] = i;
+        }
+    }
+
+    const auto by_file{ [&](const DistrObject& distr_obj) { return rank[distr_obj.file]; } };
+    for (const auto form_id : affected) {
+        const auto it{ Map::distr_map.find(form_id) };
+        if (it == Map::distr_map.end()) {
+            continue;
+        }
+
+        auto& [to_add, to_remove, to_remove_all]{ it->second };
+        if (to_add.empty() && to_remove.empty() && to_remove_all.empty()) {
+            Map::distr_map.erase(it);
+            continue;
+        }
+        std::ranges::stable_sort(to_add, {}, by_file);
+        std::ranges::stable_sort(to_remove, {}, by_file);
+        std::ranges::stable_sort(to_remove_all, {}, by_file);
+    }
+
+    RuleTable::Patch(std::vector<RE::FormID>{ affected.begin(), affected.end() });
+
+    logger::info("Reloaded {} files, {} containers changed, in {:.1f} ms", changed_files.size(), affected.size(),
+                 std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    logger::info("");
+}
@@ -0,0 +1,134 @@
+#include "Resolver.h"
+
+#include "Game.h"
+#include "ParseLog.h"
+
+namespace
+{
+    [[nodiscard]] std::string ToLower(const std::string_view s) noexcept
+    {
+        std::string result{ s };
+        std::ranges::transform(result, result.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+        return result;
+    }
+} // namespace
+
+FormIDAndPluginName Resolver::GetFormIDAndPluginName(const std::string_view identifier, const std::size_t tilde_pos) noexcept
+{
+    if (const auto form_id{ Map::ToFormID(identifier.substr(0, tilde_pos)) }) {
+        return { .form_id = *form_id, .plugin_name = identifier.substr(tilde_pos + 1) };
+    }
+    ParseLog::error("\t\tERROR: Failed to get FormID and plugin name for {}", identifier);
+
+    return { .form_id = 0x0, .plugin_name = "" };
+}
+
+RE::FormID Resolver::ToLoadedFormID(const FormIDAndPluginName& form_id_and_plugin_name) noexcept
+{
+    const auto& [form_id, plugin_name]{ form_id_and_plugin_name };
+
+    const auto it{ plugin_indices.find(ToLower(plugin_name)) };
+    if (it == plugin_indices.end()) {
+        return 0x0U;
+    }
+
+    if (const auto& [compile_index, small_file_compile_index, is_light]{ it->second }; is_light) {
+        return 0xFE000000U | static_cast<RE::FormID>(small_file_compile_index) << 12 | (form_id & 0xFFFU);
+    }
+    else {
+        return static_cast<RE::FormID>(compile_index) << 24 | (form_id & 0xFFFFFFU);
+    }
+}
+
+Resolver::ResolvedForm Resolver::Resolve(const std::string_view identifier) noexcept
+{
+    {
+        std::shared_lock lock{ resolved_forms_lock };
+        if (const auto it{ resolved_forms.find(identifier) }; it != resolved_forms.end()) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Editor IDs have no '~'
+    ResolvedForm resolved{};
+    if (const auto tilde_pos{ identifier.find('~') }; tilde_pos == std::string_view::npos) {
+        if (const auto form{ Game::LookupByEditorID(identifier) }) {
+            resolved = { .form = form, .form_id = form->GetFormID() };
+        }
+    }
+    else if (const auto form_id{ ToLoadedFormID(GetFormIDAndPluginName(identifier, tilde_pos)) }) {
+        resolved = { .form = Game::LookupByID(form_id), .form_id = form_id };
+    }
+
+    std::unique_lock lock{ resolved_forms_lock };
+    resolved_forms.try_emplace(std::string{ identifier }, resolved);
+
+    return resolved;
+}
+
+void Resolver::Reset() noexcept
+{
+    plugin_indices.clear();
+    resolved_forms.clear();
+    hits   = 0;
+    misses = 0;
+
+    for (const auto& [name, compile_index, small_file_compile_index, is_light] : Game::GetPlugins()) {
+        plugin_indices.try_emplace(ToLower(name), PluginIndex{ .compile_index = compile_index, .small_file_compile_index = small_file_compile_index, .is_light = is_light });
+    }
+    ready = true;
+}
+
+void Resolver::LogStats() noexcept
+{
+    const auto h{ hits.load() };
+    const auto m{ misses.load() };
+
+    logger::debug("Resolver: {} lookups, {} cache hits, {} misses ({} distinct identifiers, {} plugins)", h + m, h, m, resolved_forms.size(), plugin_indices.size());
+}
+
+RE::TESBoundObject* Resolver::GetBoundObject(const std::string_view identifier) noexcept
+{
+    if (const auto bound_obj{ LookupForm<RE::TESBoundObject>(identifier) }) {
+        return bound_obj;
+    }
+    ParseLog::warn("\t\tWARNING: Failed to find bound object for {}", identifier);
+
+    return nullptr;
+}
+
+RE::FormID Resolver::GetContainerFormID(const std::string_view to_identifier) noexcept
+{
+    return Resolve(to_identifier).form_id;
+}
+
+RE::BGSLocation* Resolver::GetLocation(const std::string_view identifier) noexcept
+{
+    if (identifier.empty()) {
+        return nullptr;
+    }
+
+    if (const auto location{ LookupForm<RE::BGSLocation>(identifier) }) {
+        return location;
+    }
+    ParseLog::warn("\t\tWARNING: Failed to find location for {}", identifier);
+
+    return nullptr;
+}
+
+RE::BGSKeyword* Resolver::GetLocationKeyword(const std::string_view identifier) noexcept
+{
+    if (identifier.empty()) {
+        return nullptr;
+    }
+
+    if (const auto location_keyword{ LookupForm<RE::BGSKeyword>(identifier) }) {
+        return location_keyword;
+    }
+    ParseLog::warn("\t\tWARNING: Failed to find location keyword for {}", identifier);
+
+    return nullptr;
+}
@@ -0,0 +1,306 @@
+#include "RuleTable.h"
+
+#include "Settings.h"
+
+bool RuleTable::BuildPerfectHash(const u64 slot_count) noexcept
+{
+    constexpr u16 max_pilot{ std::numeric_limits<u16>::max() };
+
+    slot_mask = slot_count - 1;
+    slots.assign(slot_count, empty_slot);
+    pilots.assign(std::max<std::size_t>(entries.size() / 4, 1), 0);
+
+    std::vector<std::vector<u32>> buckets(pilots.size());
+    for (u32 i{}; i < entries.size(); ++i) {
+        buckets[Hash(entries[i].form_id, 0) % pilots.size()].emplace_back(i);
+    }
+
+    std::vector<u32> bucket_order(buckets.size());
+    std::iota(bucket_order.begin(), bucket_order.end(), 0U);
+    std::ranges::stable_sort(bucket_order, std::greater{}, [&](const u32 b) { return buckets[b].size(); });
+
+    std::vector<u64> candidate_slots;
+    for (const auto b : bucket_order) {
+        const auto& bucket{ buckets[b] };
+        if (bucket.empty()) {
+            break;
+        }
+
+        auto placed{ false };
+        for (u16 pilot{}; pilot < max_pilot && !placed; ++pilot) {
+            candidate_slots.clear();
+            placed = std::ranges::all_of(bucket, [&](const u32 i) {
+                const auto slot{ Hash(entries[i].form_id, PilotSeed(pilot)) & slot_mask };
+                if (slots[slot] != empty_slot || std::ranges::contains(candidate_slots, slot)) {
+                    return false;
+                }
+                candidate_slots.emplace_back(slot);
+                return true;
+            });
+
+            if (placed) {
+                pilots[b] = pilot;
+                for (std::size_t j{}; j < bucket.size(); ++j) {
+                    slots[candidate_slots[j]] = bucket[j];
+                }
+            }
+        }
+
+        if (!placed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RuleTable::BuildFilter() noexcept
+{
+    // ~16 bits per container keeps the false positive rate well under 1%
+    filter.assign(std::max<std::size_t>((entries.size() * 16 + 511) / 512, 1), {});
+
+    for (const auto& entry : entries) {
+        const auto hash{ Hash(entry.form_id, 0) };
+        auto&      [words]{ filter[(hash >> 36) % filter.size()] };
+        for (auto i{ 0 }; i < 4; ++i) {
+            const auto bit{ hash >> (i * 9) & 511 };
+            words[bit >> 6] |= 1ULL << (bit & 63);
+        }
+    }
+}
+
+void RuleTable::BuildIndex() noexcept
+{
+    // Start at a load factor of at most 0.8 and grow until every bucket finds a pilot, which in practice succeeds on the first try
+    for (auto slot_count{ std::bit_ceil(entries.size() + entries.size() / 4 + 1) };; slot_count *= 2) {
+        if (BuildPerfectHash(slot_count)) {
+            break;
+        }
+        logger::debug("RuleTable: failed to build perfect hash with {} slots, retrying", slot_count);
+    }
+
+    BuildFilter();
+}
+
+void RuleTable::AppendRuleForms(const std::size_t first_rule, std::vector<RE::FormID>& out) noexcept
+{
+    for (const auto& [bound_object, location, location_keyword, count, chance, index] : std::span{ rules }.subspan(first_rule)) {
+        out.emplace_back(bound_object->GetFormID());
+        if (location) {
+            out.emplace_back(location->GetFormID());
+        }
+        if (location_keyword) {
+            out.emplace_back(location_keyword->GetFormID());
+        }
+    }
+}
+
+RuleTable::TypeRange RuleTable::AppendRules(const TDistrVec& vec, const bool leveled) noexcept
+{
+    const auto to_frozen{ [](const DistrObject& distr_obj, const u32 index) {
+        const auto& [type, container_form_id, bound_object, count, location, location_keyword, chance, file]{ distr_obj };
+        return FrozenRule{ .bound_object = bound_object, .location = location, .location_keyword = location_keyword, .count = count, .chance = chance, .index = index };
+    } };
+
+    TypeRange range{ .unconditional_begin = static_cast<u32>(rules.size()) };
+
+    // (is keyword, key, index) sorts location groups before keyword groups and keeps parse order inside each group
+    thread_local std::vector<std::tuple<bool, RE::FormID, u32>> conditional;
+    conditional.clear();
+
+    for (u32 i{}; i < vec.size(); ++i) {
+        if (const auto& distr_obj{ vec[i] }; (distr_obj.bound_object->As<RE::TESLevItem>() != nullptr) != leveled) {
+            continue;
+        }
+        else if (distr_obj.location) {
+            conditional.emplace_back(false, distr_obj.location->GetFormID(), i);
+        }
+        else if (distr_obj.location_keyword) {
+            conditional.emplace_back(true, distr_obj.location_keyword->GetFormID(), i);
+        }
+        else {
+            rules.emplace_back(to_frozen(distr_obj, i));
+        }
+    }
+    range.unconditional_end = static_cast<u32>(rules.size());
+    range.groups_begin      = static_cast<u32>(groups.size());
+
+    std::ranges::sort(conditional);
+    for (std::size_t i{}; i < conditional.size();) {
+        const auto [is_keyword, key, first_index]{ conditional[i] };
+        const auto begin{ rules.size() };
+        for (; i < conditional.size() && std::get<0>(conditional[i]) == is_keyword && std::get<1>(conditional[i]) == key; ++i) {
+            rules.emplace_back(to_frozen(vec[std::get<2>(conditional[i])], std::get<2>(conditional[i])));
+        }
+        groups.emplace_back(key, is_keyword, std::span{ rules }.subspan(begin, rules.size() - begin));
+    }
+    range.groups_end = static_cast<u32>(groups.size());
+
+    return range;
+}
+
+void RuleTable::Freeze() noexcept
+{
+    std::size_t             dropped_rules{};
+    std::vector<RE::FormID> form_ids{};
+
+    {
+        std::unique_lock l{ lock };
+
+        rules.clear();
+        groups.clear();
+        entries.clear();
+
+        std::size_t rule_count{};
+        for (const auto& [form_id, distr_vecs] : Map::distr_map) {
+            rule_count += distr_vecs.to_add.size() + distr_vecs.to_remove.size() + distr_vecs.to_remove_all.size();
+        }
+        dropped_rules = rule_count;
+        // Groups hold spans into rules, so it must never reallocate while they are built. With hot reload, Patch appends after the end for as long as it fits
+        rules.reserve(Settings::watch_inis ? rule_count + rule_count / 4 + 1024 : rule_count);
+        entries.reserve(Map::distr_map.size());
+
+        for (const auto& [form_id, distr_vecs] : Map::distr_map) {
+            const auto& [to_add, to_remove, to_remove_all]{ distr_vecs };
+            entries.emplace_back(form_id, std::array{ AppendRules(to_add, false), AppendRules(to_add, true), AppendRules(to_remove, false), AppendRules(to_remove_all, false) });
+        }
+
+        BuildIndex();
+
+        dropped_rules -= rules.size();
+
+        form_ids.reserve(rules.size() * 3 + entries.size());
+        AppendRuleForms(0, form_ids);
+        for (const auto& entry : entries) {
+            form_ids.emplace_back(entry.form_id);
+        }
+    }
+
+    // Formatting rules in debug and distribution logs must not call into po3_Tweaks for each one. Their editor IDs are only looked up once a message needs them
+    EditorIDs::SetRuleForms(form_ids);
+
+    // Removing a leveled list never did anything, so those rules are left out
+    if (dropped_rules) {
+        logger::info("Ignored {} remove rules for leveled lists", dropped_rules);
+    }
+
+    if (Settings::debug_logging) {
+        LogMeasurements();
+    }
+
+    logger::info("Froze {} rules for {} containers", rules.size(), entries.size());
+
+    // Hot reload patches distr_map and then the table
+    if (!Settings::watch_inis) {
+        Map::distr_map = {};
+    }
+}
+
+void RuleTable::Patch(const std::span<const RE::FormID> form_ids) noexcept
+{
+    std::size_t rule_count{};
+    for (const auto form_id : form_ids) {
+        if (const auto it{ Map::distr_map.find(form_id) }; it != Map::distr_map.end()) {
+            const auto& [to_add, to_remove, to_remove_all]{ it->second };
+            rule_count += to_add.size() + to_remove.size() + to_remove_all.size();
+        }
+    }
+
+    // The replaced rules stay behind as garbage until then, so it also bounds that
+    if (rules.size() + rule_count > rules.capacity()) {
+        Freeze();
+        return;
+    }
+
+    std::vector<RE::FormID> rule_forms{};
+    std::vector<RE::FormID> removed{};
+    auto                    reindex{ false };
+    std::size_t             patched_rules{};
+
+    {
+        std::unique_lock l{ lock };
+
+        const auto first_rule{ rules.size() };
+        for (const auto form_id : form_ids) {
+            const auto index{ EntryIndex(form_id) };
+            const auto it{ Map::distr_map.find(form_id) };
+            if (it == Map::distr_map.end()) {
+                if (index != empty_slot) {
+                    removed.emplace_back(form_id);
+                }
+                continue;
+            }
+
+            const auto& [to_add, to_remove, to_remove_all]{ it->second };
+            const std::array ranges{ AppendRules(to_add, false), AppendRules(to_add, true), AppendRules(to_remove, false), AppendRules(to_remove_all, false) };
+            if (index != empty_slot) {
+                entries[index].ranges = ranges;
+            }
+            else {
+                entries.emplace_back(form_id, ranges);
+                reindex = true;
+            }
+            rule_forms.emplace_back(form_id);
+        }
+
+        // Removed only now, since EntryIndex relies on the slots built for the old order
+        if (!removed.empty()) {
+            std::erase_if(entries, [&](const Entry& entry) { return std::ranges::contains(removed, entry.form_id); });
+            reindex = true;
+        }
+        if (reindex) {
+            BuildIndex();
+        }
+
+        patched_rules = rules.size() - first_rule;
+        AppendRuleForms(first_rule, rule_forms);
+    }
+
+    EditorIDs::AddRuleForms(rule_forms);
+
+    logger::info("Patched {} rules for {} containers, {} containers in total", patched_rules, form_ids.size(), entries.size());
+}
+
+void RuleTable::LogMeasurements() noexcept
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto map_bytes{ Map::DistrMapMemoryUsage() };
+
+    constexpr auto rounds{ 16 };
+
+    std::vector<RE::FormID> keys;
+    keys.reserve(entries.size() * 2);
+    for (const auto& entry : entries) {
+        keys.emplace_back(entry.form_id);
+        keys.emplace_back(entry.form_id ^ 0x00800000U); // Mostly misses, like most references
+    }
+
+    std::size_t sink{};
+
+    const auto map_start{ clock::now() };
+    for (auto r{ 0 }; r < rounds; ++r) {
+        for (const auto key : keys) {
+            if (const auto it{ Map::distr_map.find(key) }; it != Map::distr_map.end()) {
+                sink += it->second.to_add.size();
+            }
+        }
+    }
+    const auto map_time{ clock::now() - map_start };
+
+    const auto table_start{ clock::now() };
+    for (auto r{ 0 }; r < rounds; ++r) {
+        for (const auto key : keys) {
+            if (const auto container_rules{ Find(key) }) {
+                sink += container_rules->to_add.unconditional.size();
+            }
+        }
+    }
+    const auto table_time{ clock::now() - table_start };
+
+    const auto lookups{ static_cast<double>(std::max<std::size_t>(keys.size() * rounds, 1)) };
+
+    logger::debug("RuleTable: distr_map {} bytes, {:.1f} ns/lookup -> frozen table {} bytes, {:.1f} ns/lookup ({})", map_bytes,
+                  std::chrono::duration<double, std::nano>(map_time).count() / lookups, MemoryUsage(), std::chrono::duration<double, std::nano>(table_time).count() / lookups,
+                  sink);
+}
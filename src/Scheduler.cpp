@@ -0,0 +1,136 @@
+#include "Scheduler.h"
+
+#include "Distributor.h"
+#include "Game.h"
+#include "Map.h"
+#include "RuleTable.h"
+#include "Settings.h"
+#include "Stats.h"
+
+std::optional<Scheduler::Entry> Scheduler::Pop() noexcept
+{
+    std::scoped_lock l{ lock };
+    if (queue.empty()) {
+        return std::nullopt;
+    }
+
+    const auto entry{ queue.front() };
+    queue.pop_front();
+    queued.erase(entry.form_id);
+
+    return entry;
+}
+
+void Scheduler::Enqueue(const RE::TESObjectREFR* ref) noexcept
+{
+    const auto form_id{ ref->GetFormID() };
+
+    // Same cheap checks Distribute starts with, so references without rules never touch the queue
+    if (!RuleTable::MayContain(form_id) && !RuleTable::MayContain(ref->GetBaseObject()->GetFormID())) {
+        return;
+    }
+    if (Map::processed_containers.Contains(form_id)) {
+        return;
+    }
+
+    Push({ .form_id = form_id });
+}
+
+void Scheduler::Push(const Entry entry) noexcept
+{
+    std::scoped_lock l{ lock };
+    if (queued.insert(entry.form_id).second) {
+        queue.emplace_back(entry);
+    }
+}
+
+void Scheduler::RunFrame() noexcept
+{
+    using clock = std::chrono::steady_clock;
+
+    Stats::Timer timer{ Probe::SchedulerFrame };
+
+    const auto start{ clock::now() };
+    const auto deadline{ start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double, std::milli>(Settings::frame_budget_ms)) };
+
+    // Refs pushed back below wait for the next frame
+    const auto pending{ QueueDepth() };
+
+    u32         distributed{};
+    std::size_t popped{};
+    // At least one per frame, so the queue always drains
+    do {
+        if (popped++ == pending) {
+            break;
+        }
+        const auto entry{ Pop() };
+        if (!entry) {
+            break;
+        }
+        const auto& [form_id, frames_waited]{ *entry };
+        const auto ref{ Game::LookupByID<RE::TESObjectREFR>(form_id) };
+        if (!ref || Game::IsDetached(ref)) {
+            continue;
+        }
+        // Load3D runs before the 3D exists, and with background loading it arrives frames later without another Load3D call
+        if (!Game::Is3DLoaded(ref)) {
+            if (frames_waited < max_frames_waited) {
+                Push({ .form_id = form_id, .frames_waited = frames_waited + 1 });
+            }
+            else {
+                logger::debug("Scheduler: dropped {:#x}, its 3D did not load in {} frames", form_id, max_frames_waited);
+            }
+            continue;
+        }
+        Distributor::Distribute(ref);
+        ++distributed;
+    }
+    while (clock::now() < deadline);
+
+    if (distributed) {
+        logger::debug("Scheduler: distributed {} refs in {:.3f} ms, {} still queued", distributed, std::chrono::duration<double, std::milli>(clock::now() - start).count(),
+                      QueueDepth());
+    }
+}
+
+void Scheduler::Flush(RE::TESObjectREFR* ref) noexcept
+{
+    {
+        std::scoped_lock l{ lock };
+        if (!queued.erase(ref->GetFormID())) {
+            return;
+        }
+        std::erase_if(queue, [&](const Entry& entry) { return entry.form_id == ref->GetFormID(); });
+    }
+
+    Distributor::Distribute(ref);
+}
+
+void Scheduler::OnResetInventory(RE::TESObjectREFR* ref, const bool leveled_only) noexcept
+{
+    const auto form_id{ ref->GetFormID() };
+
+    if (!leveled_only) {
+        Map::added_objects.Erase(form_id);
+    }
+
+    if (Map::respawn_containers.Contains(form_id)) {
+        Map::processed_containers.Erase(form_id);
+        Enqueue(ref);
+    }
+}
+
+void Scheduler::Clear() noexcept
+{
+    std::scoped_lock l{ lock };
+
+    queue.clear();
+    queued.clear();
+}
+
+std::size_t Scheduler::QueueDepth() noexcept
+{
+    std::scoped_lock l{ lock };
+
+    return queue.size();
+}
@@ -11,6 +11,23 @@ void Settings::LoadSettings() noexcept
 
     debug_logging = ini.GetBoolValue("Log", "Debug");
 
+    use_cache = ini.GetBoolValue("Cache", "Enabled", true);
+
+    deterministic_chance = ini.GetBoolValue("Chance", "Deterministic");
+    chance_seed          = static_cast<u64>(ini.GetLongValue("Chance", "Seed"));
+
+    frame_budget_ms = ini.GetDoubleValue("Scheduler", "FrameBudgetMs", 1.0);
+
+    watch_inis        = ini.GetBoolValue("Watch", "Enabled");
+    watch_interval_ms = static_cast<u32>(std::max(ini.GetLongValue("Watch", "IntervalMs", 1000), 100L));
+
+    stats_enabled    = ini.GetBoolValue("Stats", "Enabled");
+    stats_interval_s = static_cast<u32>(std::max(ini.GetLongValue("Stats", "IntervalSeconds", 60), 1L));
+
+    if (deterministic_chance) {
+        logger::info("Deterministic chance rolls enabled with seed {}", chance_seed);
+    }
+
     if (debug_logging) {
         spdlog::set_level(spdlog::level::debug);
         logger::debug("Debug logging enabled");
@@ -0,0 +1,128 @@
+#include "Stats.h"
+
+#include "Game.h"
+#include "Map.h"
+#include "RuleTable.h"
+#include "Scheduler.h"
+
+namespace
+{
+    constexpr std::array probe_names{ "Load3D"sv,         "Load3DCharacter"sv,    "ResetInventory"sv, "SaveGame"sv,      "Distribute"sv,
+                                      "SchedulerFrame"sv, "ParseDirectoryScan"sv, "ParseINILoad"sv,   "ParseTokenize"sv, "ParseResolve"sv };
+    static_assert(probe_names.size() == std::to_underlying(Probe::Count));
+
+    constexpr std::size_t bucket_count{ 40 };
+
+    struct alignas(64) Histogram
+    {
+        std::atomic<u64>                            calls{};
+        std::atomic<u64>                            total_ns{};
+        std::atomic<u64>                            max_ns{};
+        std::array<std::atomic<u64>, bucket_count> buckets{};
+    };
+
+    std::array<Histogram, std::to_underlying(Probe::Count)> histograms{};
+}
+
+std::filesystem::path Stats::GetPath() noexcept
+{
+    if (const auto log_dir{ Game::GetLogDirectory() }) {
+        return *log_dir / std::format("{}.stats.json", Game::GetPluginName());
+    }
+
+    return {};
+}
+
+void Stats::Start() noexcept
+{
+    if (!Settings::stats_enabled) {
+        return;
+    }
+
+    start_time = std::chrono::steady_clock::now();
+
+    logger::info("Stats enabled, writing a summary every {} s", Settings::stats_interval_s);
+
+    // Detached for the same reason as the DistrLog thread
+    std::thread{ Run }.detach();
+}
+
+void Stats::Record(const Probe probe, const u64 ns) noexcept
+{
+    auto& [calls, total_ns, max_ns, buckets]{ histograms[std::to_underlying(probe)] };
+
+    calls.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(ns, std::memory_order_relaxed);
+    buckets[std::min<std::size_t>(std::bit_width(ns), bucket_count - 1)].fetch_add(1, std::memory_order_relaxed);
+
+    for (auto max{ max_ns.load(std::memory_order_relaxed) }; ns > max && !max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed);) {}
+}
+
+void Stats::Run() noexcept
+{
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds{ Settings::stats_interval_s });
+        WriteSummary();
+    }
+}
+
+void Stats::WriteSummary() noexcept
+{
+    const auto path{ GetPath() };
+    if (path.empty()) {
+        return;
+    }
+
+    const auto uptime{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() };
+
+    std::string json{ "{\n" };
+    auto        out{ std::back_inserter(json) };
+
+    std::format_to(out, "  \"version\": \"{}\",\n  \"uptime_s\": {:.1f},\n  \"probes\": {{\n", Game::GetPluginVersion(), uptime);
+
+    for (std::size_t i{}; i < histograms.size(); ++i) {
+        const auto& [calls, total_ns, max_ns, buckets]{ histograms[i] };
+        const auto n{ calls.load(std::memory_order_relaxed) };
+        const auto total{ total_ns.load(std::memory_order_relaxed) };
+
+        std::format_to(out, "    \"{}\": {{ \"calls\": {}, \"total_us\": {:.1f}, \"mean_us\": {:.3f}, \"max_us\": {:.1f}, \"histogram\": [", probe_names[i], n, total / 1000.0,
+                       n ? total / 1000.0 / static_cast<double>(n) : 0.0, max_ns.load(std::memory_order_relaxed) / 1000.0);
+
+        // Bucket b counts durations below 2^b ns
+        auto first{ true };
+        for (std::size_t b{}; b < bucket_count; ++b) {
+            if (const auto count{ buckets[b].load(std::memory_order_relaxed) }) {
+                std::format_to(out, "{}{{ \"lt_ns\": {}, \"count\": {} }}", first ? "" : ", ", 1ULL << b, count);
+                first = false;
+            }
+        }
+
+        std::format_to(out, "] }}{}\n", i + 1 < histograms.size() ? "," : "");
+    }
+
+    std::format_to(out, "  }},\n  \"containers\": {{\n");
+    std::format_to(out, "    \"processed_containers\": {{ \"size\": {}, \"bytes\": {} }},\n", Map::processed_containers.Size(), Map::processed_containers.MemoryUsage());
+    std::format_to(out, "    \"respawn_containers\": {{ \"size\": {}, \"bytes\": {} }},\n", Map::respawn_containers.Size(), Map::respawn_containers.MemoryUsage());
+    std::format_to(out, "    \"added_objects\": {{ \"size\": {}, \"bytes\": {} }},\n", Map::added_objects.Size(), Map::added_objects.MemoryUsage());
+    std::format_to(out, "    \"rule_table\": {{ \"size\": {}, \"bytes\": {} }},\n", RuleTable::Size(), RuleTable::MemoryUsage());
+    std::format_to(out, "    \"editor_ids\": {{ \"size\": {}, \"bytes\": {} }},\n", EditorIDs::Size(), EditorIDs::MemoryUsage());
+    std::format_to(out, "    \"scheduler_queue\": {{ \"size\": {} }}\n  }}\n}}\n", Scheduler::QueueDepth());
+
+    auto tmp_path{ path };
+    tmp_path += ".tmp";
+
+    {
+        std::ofstream file{ tmp_path, std::ios::trunc };
+        file << json;
+        if (!file) {
+            logger::error("ERROR: Failed to write stats {}", tmp_path.filename().string());
+            return;
+        }
+    }
+
+    std::error_code ec{};
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        logger::error("ERROR: Failed to replace stats {} ({})", path.filename().string(), ec.message());
+    }
+}
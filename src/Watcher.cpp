@@ -0,0 +1,88 @@
+#include "Watcher.h"
+
+#include "Parser.h"
+#include "Settings.h"
+
+Watcher::Snapshot Watcher::TakeSnapshot() noexcept
+{
+    Snapshot result;
+    for (auto& path : Parser::FindINIs()) {
+        std::error_code ec{};
+        const auto      write_time{ std::filesystem::last_write_time(path, ec) };
+        const auto      size{ ec ? 0 : std::filesystem::file_size(path, ec) };
+        if (!ec) {
+            result.emplace(std::move(path), FileState{ write_time, size });
+        }
+    }
+
+    return result;
+}
+
+void Watcher::Start() noexcept
+{
+    if (!Settings::watch_inis) {
+        return;
+    }
+
+    snapshot = TakeSnapshot();
+
+    logger::info("Watching {} _CID.ini files for changes every {} ms", snapshot.size(), Settings::watch_interval_ms);
+
+    // Detached for the same reason as the DistrLog thread
+    std::thread{ Run }.detach();
+}
+
+void Watcher::Run() noexcept
+{
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ Settings::watch_interval_ms });
+
+        auto current{ TakeSnapshot() };
+
+        std::vector<std::filesystem::path> changed;
+        for (const auto& [path, state] : current) {
+            if (const auto it{ snapshot.find(path) }; it == snapshot.end() || it->second != state) {
+                changed.emplace_back(path);
+            }
+        }
+        for (const auto& [path, state] : snapshot) {
+            if (!current.contains(path)) {
+                changed.emplace_back(path);
+            }
+        }
+        snapshot = std::move(current);
+
+        if (changed.empty()) {
+            continue;
+        }
+
+        bool schedule{};
+        {
+            std::scoped_lock l{ lock };
+            schedule = pending.empty();
+            for (auto& path : changed) {
+                if (!std::ranges::contains(pending, path)) {
+                    pending.emplace_back(std::move(path));
+                }
+            }
+        }
+
+        // One task at a time; later changes are picked up by the task already queued
+        if (schedule) {
+            SKSE::GetTaskInterface()->AddTask(Apply);
+        }
+    }
+}
+
+void Watcher::Apply() noexcept
+{
+    std::vector<std::filesystem::path> changed;
+    {
+        std::scoped_lock l{ lock };
+        changed.swap(pending);
+    }
+
+    std::ranges::sort(changed);
+
+    Parser::ReloadINIs(changed);
+}